@@ -0,0 +1,208 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "anytime_search.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace astar_path_planner
+{
+
+AnytimeSearch::AnytimeSearch(
+  const PlanningContext & context, const CostScaleTable & cost_scale,
+  const double initial_weight)
+: context_(context),
+  cost_scale_(cost_scale),
+  initial_weight_(std::max(initial_weight, 1.0)),
+  suboptimality_bound_(std::numeric_limits<double>::infinity())
+{
+}
+
+std::vector<Cell> AnytimeSearch::Search(
+  const Cell & start, const Cell & goal, const Clock::time_point & deadline,
+  std::vector<bool> & expanded)
+{
+  const auto cell_count = context_.GetGrid().GetCellCount();
+  goal_ = goal;
+  weight_ = initial_weight_;
+  suboptimality_bound_ = std::numeric_limits<double>::infinity();
+  states_.clear();
+  inconsistent_.clear();
+  frontier_.clear();
+  expanded.assign(cell_count, false);
+  iteration_ = 1;
+
+  states_[start] = {0.0, start};
+  frontier_.push_back({start, weight_ * GetHeuristicCost(start), 0.0});
+
+  // Even if the deadline cuts an iteration short, any path it reached is kept, with the bound the
+  // frontier can prove instead of the weight
+  std::vector<Cell> path;
+  auto finished = ImprovePath(deadline, expanded);
+  while (GetPathCost(goal_) != std::numeric_limits<double>::infinity()) {
+    path = ReconstructPath(goal_);
+    // A later path is never worse, so bounds proven for earlier paths still hold
+    suboptimality_bound_ = std::min(suboptimality_bound_, ComputeSuboptimalityBound());
+    if (finished) {
+      suboptimality_bound_ = std::min(suboptimality_bound_, weight_);
+    }
+    if (!finished || suboptimality_bound_ <= 1.0 || Clock::now() >= deadline) {
+      break;
+    }
+    weight_ = std::max(weight_ - kWeightStep, 1.0);
+    ++iteration_;
+    RebuildFrontier();
+    finished = ImprovePath(deadline, expanded);
+  }
+
+  return path;
+}
+
+bool AnytimeSearch::ImprovePath(const Clock::time_point & deadline, std::vector<bool> & expanded)
+{
+  const auto & grid = context_.GetGrid();
+  const auto & collision_map = context_.GetCollisionMap();
+  const FrontierEntryComparator comparator;
+  int expansions = 0;
+
+  // The goal's key is just its cost, since its heuristic is zero
+  while (!frontier_.empty() && frontier_.front().cost < GetPathCost(goal_)) {
+    if (++expansions % kDeadlineCheckInterval == 0 && Clock::now() >= deadline) {
+      return false;
+    }
+
+    std::pop_heap(frontier_.begin(), frontier_.end(), comparator);
+    const auto entry = frontier_.back();
+    frontier_.pop_back();
+
+    // Skip cells already expanded this iteration and entries superseded by a cheaper one
+    auto & state = states_[entry.cell];
+    if (state.closed_iteration == iteration_ || entry.path_cost != state.path_cost) {
+      continue;
+    }
+    state.closed_iteration = iteration_;
+    expanded[entry.cell] = true;
+
+    const auto x = grid.GetX(entry.cell);
+    const auto y = grid.GetY(entry.cell);
+    for (const auto & move : context_.GetMoves()) {
+      if (!grid.IsInBounds(x + move.dx, y + move.dy)) {
+        continue;
+      }
+      const Cell next_cell = entry.cell + move.offset;
+      if (collision_map.IsCellInCollision(next_cell)) {
+        continue;
+      }
+      const auto new_path_cost =
+        entry.path_cost + move.distance * cost_scale_[context_.GetCellCost(next_cell)];
+      auto & next_state = states_[next_cell];
+      if (new_path_cost >= next_state.path_cost) {
+        continue;
+      }
+      next_state.path_cost = new_path_cost;
+      next_state.parent = entry.cell;
+      if (next_state.closed_iteration == iteration_) {
+        // Already expanded with the old cost, so hold it until the next iteration
+        if (!next_state.inconsistent) {
+          next_state.inconsistent = true;
+          inconsistent_.push_back(next_cell);
+        }
+      } else {
+        frontier_.push_back(
+          {next_cell, new_path_cost + weight_ * GetHeuristicCost(next_cell), new_path_cost});
+        std::push_heap(frontier_.begin(), frontier_.end(), comparator);
+      }
+    }
+  }
+
+  return true;
+}
+
+void AnytimeSearch::RebuildFrontier()
+{
+  frontier_.erase(
+    std::remove_if(
+      frontier_.begin(), frontier_.end(),
+      [this](const FrontierEntry & entry) {return entry.path_cost != GetPathCost(entry.cell);}),
+    frontier_.end());
+  for (const auto & cell : inconsistent_) {
+    auto & state = states_[cell];
+    state.inconsistent = false;
+    frontier_.push_back({cell, 0.0, state.path_cost});
+  }
+  inconsistent_.clear();
+  for (auto & entry : frontier_) {
+    entry.cost = entry.path_cost + weight_ * GetHeuristicCost(entry.cell);
+  }
+  std::make_heap(frontier_.begin(), frontier_.end(), FrontierEntryComparator{});
+}
+
+double AnytimeSearch::ComputeSuboptimalityBound() const
+{
+  // Every cheaper path would have to pass through a frontier or inconsistent cell, so the
+  // smallest unweighted key among them is a lower bound on the optimal cost
+  const auto goal_cost = GetPathCost(goal_);
+  auto lower_bound = goal_cost;
+  for (const auto & entry : frontier_) {
+    if (entry.path_cost == GetPathCost(entry.cell)) {
+      lower_bound = std::min(lower_bound, entry.path_cost + GetHeuristicCost(entry.cell));
+    }
+  }
+  for (const auto & cell : inconsistent_) {
+    lower_bound = std::min(lower_bound, GetPathCost(cell) + GetHeuristicCost(cell));
+  }
+  if (lower_bound <= 0.0) {
+    return 1.0;
+  }
+  return goal_cost / lower_bound;
+}
+
+double AnytimeSearch::GetPathCost(const Cell & cell) const
+{
+  const auto state = states_.find(cell);
+  if (state == states_.end()) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return state->second.path_cost;
+}
+
+double AnytimeSearch::GetHeuristicCost(const Cell & cell) const
+{
+  const auto & grid = context_.GetGrid();
+  const auto dx = grid.GetX(cell) - grid.GetX(goal_);
+  const auto dy = grid.GetY(cell) - grid.GetY(goal_);
+  return grid.GetGridSize() * std::hypot(dx, dy);
+}
+
+std::vector<Cell> AnytimeSearch::ReconstructPath(Cell cell) const
+{
+  std::vector<Cell> path{cell};
+  while (states_.at(cell).parent != cell) {
+    cell = states_.at(cell).parent;
+    path.push_back(cell);
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+}  // namespace astar_path_planner
@@ -0,0 +1,109 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef ANYTIME_SEARCH_HPP_
+#define ANYTIME_SEARCH_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include "planning_context.hpp"
+#include "search_grid.hpp"
+#include "utils.hpp"
+
+namespace astar_path_planner
+{
+
+// Anytime Repairing A* (Likhachev, Gordon & Thrun, 2003) over the search grid.
+// A weighted A* quickly finds a path whose cost is within a factor of the heuristic weight of
+// optimal. The weight is then lowered step by step, reusing the previous search effort, until the
+// path is proven optimal or the deadline passes.
+class AnytimeSearch
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  AnytimeSearch(
+    const PlanningContext & context, const CostScaleTable & cost_scale,
+    const double initial_weight);
+
+  // Returns the cells of the best path found before the deadline, or an empty vector if no path
+  // was reached in time or none exists. Every expanded cell is marked in `expanded`.
+  std::vector<Cell> Search(
+    const Cell & start, const Cell & goal, const Clock::time_point & deadline,
+    std::vector<bool> & expanded);
+
+  // Upper bound on the last returned path's cost divided by the optimal cost
+  double GetSuboptimalityBound() const
+  {
+    return suboptimality_bound_;
+  }
+
+private:
+  // Amount the heuristic weight is lowered by after each improved path
+  static constexpr double kWeightStep = 0.5;
+  // Frontier pops between checks of the clock
+  static constexpr int kDeadlineCheckInterval = 256;
+
+  struct CellState
+  {
+    double path_cost = std::numeric_limits<double>::infinity();
+    Cell parent;
+    // Iteration in which the cell was last expanded, so the closed set resets without clearing
+    std::uint32_t closed_iteration = 0;
+    bool inconsistent = false;
+  };
+
+  const PlanningContext & context_;
+  const CostScaleTable & cost_scale_;
+  double initial_weight_;
+  double weight_;
+  double suboptimality_bound_;
+  Cell goal_;
+  std::vector<FrontierEntry> frontier_;
+  // Cells whose cost improved after they were expanded in the current iteration
+  std::vector<Cell> inconsistent_;
+  std::uint32_t iteration_;
+  // State of every cell reached so far. Kept sparse so a short deadline isn't spent clearing
+  // per-cell arrays for the whole map.
+  std::unordered_map<Cell, CellState> states_;
+
+  // Expands cells until the goal's cost is proven within the current weight or the frontier
+  // runs out. Returns false if the deadline passed first.
+  bool ImprovePath(const Clock::time_point & deadline, std::vector<bool> & expanded);
+
+  // Moves inconsistent cells back into the frontier and re-keys it for the current weight
+  void RebuildFrontier();
+
+  // Tightest bound the current frontier can prove for the goal's cost
+  double ComputeSuboptimalityBound() const;
+
+  double GetPathCost(const Cell & cell) const;
+
+  double GetHeuristicCost(const Cell & cell) const;
+
+  std::vector<Cell> ReconstructPath(Cell cell) const;
+};
+
+}  // namespace astar_path_planner
+
+#endif  // ANYTIME_SEARCH_HPP_
@@ -0,0 +1,492 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Standalone benchmark for the planner modes. Runs without the nav2 planner server, over maps
+// loaded from map_server YAML files and generated open field, clutter and maze maps.
+//
+// Besides the planner modes, "astar_radix" runs the "astar" mode with the radix heap frontier.
+// "incremental" plans each query with one D* Lite planner kept across queries, and
+// "incremental_replan" times only its second call per query, made from halfway along the first
+// path to the same goal as if the robot had driven there.
+//
+// Usage: astar_benchmark [--map <map.yaml>]... [--modes astar,jps,...] [--queries <count>]
+//                        [--seed <seed>] [--size <meters>] [--grid-size <meters>]
+//                        [--collision-radius <meters>] [--cost-weight <weight>]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <nav2_costmap_2d/cost_values.hpp>
+#include <nav2_costmap_2d/costmap_2d.hpp>
+#include <nav2_map_server/map_io.hpp>
+#include "astar_path_planner.hpp"
+#include "dstar_lite_planner.hpp"
+#include "planning_context.hpp"
+
+namespace
+{
+
+// Heap usage, tracked by the replacement allocation functions below. Atomic so that allocations
+// from any thread are counted safely.
+std::atomic<std::size_t> current_heap_bytes{0};
+std::atomic<std::size_t> peak_heap_bytes{0};
+
+// Each allocation is prefixed with its size so it can be subtracted again when freed
+constexpr std::size_t kHeaderSize = alignof(std::max_align_t);
+
+void * TrackedAllocate(const std::size_t size)
+{
+  auto * block = static_cast<unsigned char *>(std::malloc(size + kHeaderSize));
+  if (block == nullptr) {
+    throw std::bad_alloc{};
+  }
+  *reinterpret_cast<std::size_t *>(block) = size;
+  const auto current = current_heap_bytes.fetch_add(size) + size;
+  auto peak = peak_heap_bytes.load();
+  while (current > peak && !peak_heap_bytes.compare_exchange_weak(peak, current)) {
+  }
+  return block + kHeaderSize;
+}
+
+void TrackedFree(void * pointer)
+{
+  if (pointer == nullptr) {
+    return;
+  }
+  auto * block = static_cast<unsigned char *>(pointer) - kHeaderSize;
+  current_heap_bytes.fetch_sub(*reinterpret_cast<std::size_t *>(block));
+  std::free(block);
+}
+
+}  // namespace
+
+void * operator new(std::size_t size)
+{
+  return TrackedAllocate(size);
+}
+
+void * operator new[](std::size_t size)
+{
+  return TrackedAllocate(size);
+}
+
+void operator delete(void * pointer) noexcept
+{
+  TrackedFree(pointer);
+}
+
+void operator delete[](void * pointer) noexcept
+{
+  TrackedFree(pointer);
+}
+
+void operator delete(void * pointer, std::size_t) noexcept
+{
+  TrackedFree(pointer);
+}
+
+void operator delete[](void * pointer, std::size_t) noexcept
+{
+  TrackedFree(pointer);
+}
+
+namespace
+{
+
+using astar_path_planner::AStarPathPlanner;
+using astar_path_planner::BasicAStarPathPlanner;
+using astar_path_planner::Cell;
+using astar_path_planner::DStarLitePlanner;
+using astar_path_planner::PlannerParameters;
+using astar_path_planner::PlanningContext;
+using astar_path_planner::Point;
+using astar_path_planner::RadixHeapFrontier;
+using nav2_costmap_2d::Costmap2D;
+
+struct Options
+{
+  std::vector<std::string> map_files;
+  std::vector<std::string> modes{"astar", "astar_radix", "bidirectional", "jps", "theta_star",
+    "hierarchical", "anytime", "incremental", "incremental_replan"};
+  int query_count = 50;
+  unsigned int seed = 1;
+  double generated_size = 5.0;
+  double grid_size = 0.01;
+  double collision_radius = 0.08;
+  double cost_weight = 0.0;
+};
+
+struct Scenario
+{
+  std::string name;
+  std::shared_ptr<Costmap2D> costmap;
+};
+
+struct Query
+{
+  Point start;
+  Point goal;
+};
+
+constexpr double kGeneratedResolution = 0.02;
+
+std::shared_ptr<Costmap2D> MakeEmptyCostmap(const double & size)
+{
+  const auto cells = static_cast<unsigned int>(size / kGeneratedResolution);
+  auto costmap = std::make_shared<Costmap2D>(
+    cells, cells, kGeneratedResolution, -size / 2.0, -size / 2.0, nav2_costmap_2d::FREE_SPACE);
+  for (unsigned int i = 0; i < cells; ++i) {
+    costmap->setCost(i, 0, nav2_costmap_2d::LETHAL_OBSTACLE);
+    costmap->setCost(i, cells - 1, nav2_costmap_2d::LETHAL_OBSTACLE);
+    costmap->setCost(0, i, nav2_costmap_2d::LETHAL_OBSTACLE);
+    costmap->setCost(cells - 1, i, nav2_costmap_2d::LETHAL_OBSTACLE);
+  }
+  return costmap;
+}
+
+void FillRectangle(
+  Costmap2D & costmap, const unsigned int x_begin, const unsigned int y_begin,
+  const unsigned int x_end, const unsigned int y_end)
+{
+  for (auto y = y_begin; y < std::min(y_end, costmap.getSizeInCellsY()); ++y) {
+    for (auto x = x_begin; x < std::min(x_end, costmap.getSizeInCellsX()); ++x) {
+      costmap.setCost(x, y, nav2_costmap_2d::LETHAL_OBSTACLE);
+    }
+  }
+}
+
+// Random boxes between 4 and 20 cm across covering roughly a tenth of the map
+std::shared_ptr<Costmap2D> MakeClutterMap(const double & size, std::mt19937 & rng)
+{
+  auto costmap = MakeEmptyCostmap(size);
+  const auto cells = costmap->getSizeInCellsX();
+  std::uniform_int_distribution<unsigned int> position(0, cells - 1);
+  std::uniform_int_distribution<unsigned int> extent(2, 10);
+  const auto box_count = cells * cells / 360;
+  for (unsigned int i = 0; i < box_count; ++i) {
+    const auto x = position(rng);
+    const auto y = position(rng);
+    FillRectangle(*costmap, x, y, x + extent(rng), y + extent(rng));
+  }
+  return costmap;
+}
+
+// Perfect maze with 50 cm corridors, carved with a randomized depth first search
+std::shared_ptr<Costmap2D> MakeMazeMap(const double & size, std::mt19937 & rng)
+{
+  constexpr unsigned int kCorridorCells = 25;
+  constexpr unsigned int kWallCells = 3;
+  auto costmap = MakeEmptyCostmap(size);
+  const auto cells = costmap->getSizeInCellsX();
+  const int rooms = (cells - kWallCells) / (kCorridorCells + kWallCells);
+  if (rooms < 2) {
+    return costmap;
+  }
+  const auto pitch = kCorridorCells + kWallCells;
+
+  // Start fully walled, then open each room and the walls between visited rooms
+  FillRectangle(*costmap, 0, 0, cells, cells);
+  auto open_room = [&](const int rx, const int ry) {
+      const auto x = kWallCells + rx * pitch;
+      const auto y = kWallCells + ry * pitch;
+      for (auto cy = y; cy < y + kCorridorCells; ++cy) {
+        for (auto cx = x; cx < x + kCorridorCells; ++cx) {
+          costmap->setCost(cx, cy, nav2_costmap_2d::FREE_SPACE);
+        }
+      }
+    };
+  auto open_wall = [&](const int rx, const int ry, const int dx, const int dy) {
+      // The wall sits just past the room's corridor in the direction being opened
+      const auto x = kWallCells + rx * pitch + (dx > 0 ? kCorridorCells : 0) -
+        (dx < 0 ? kWallCells : 0);
+      const auto y = kWallCells + ry * pitch + (dy > 0 ? kCorridorCells : 0) -
+        (dy < 0 ? kWallCells : 0);
+      const auto width = dx != 0 ? kWallCells : kCorridorCells;
+      const auto height = dy != 0 ? kWallCells : kCorridorCells;
+      for (auto cy = y; cy < y + height; ++cy) {
+        for (auto cx = x; cx < x + width; ++cx) {
+          costmap->setCost(cx, cy, nav2_costmap_2d::FREE_SPACE);
+        }
+      }
+    };
+
+  std::vector<bool> visited(rooms * rooms, false);
+  std::vector<std::pair<int, int>> stack{{0, 0}};
+  visited[0] = true;
+  open_room(0, 0);
+  const std::vector<std::pair<int, int>> directions{{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+  while (!stack.empty()) {
+    const auto [rx, ry] = stack.back();
+    std::vector<std::pair<int, int>> options;
+    for (const auto & [dx, dy] : directions) {
+      const auto nx = rx + dx;
+      const auto ny = ry + dy;
+      if (nx >= 0 && nx < rooms && ny >= 0 && ny < rooms && !visited[ny * rooms + nx]) {
+        options.emplace_back(dx, dy);
+      }
+    }
+    if (options.empty()) {
+      stack.pop_back();
+      continue;
+    }
+    const auto [dx, dy] = options[rng() % options.size()];
+    open_wall(rx, ry, dx, dy);
+    open_room(rx + dx, ry + dy);
+    visited[(ry + dy) * rooms + rx + dx] = true;
+    stack.emplace_back(rx + dx, ry + dy);
+  }
+  return costmap;
+}
+
+std::shared_ptr<Costmap2D> LoadMap(const std::string & yaml_file)
+{
+  nav_msgs::msg::OccupancyGrid map;
+  if (nav2_map_server::loadMapFromYaml(yaml_file, map) != nav2_map_server::LOAD_MAP_SUCCESS) {
+    return nullptr;
+  }
+  return std::make_shared<Costmap2D>(map);
+}
+
+// Start and goal pairs sampled uniformly from the free cells of the planning grid
+std::vector<Query> MakeQueries(
+  const PlanningContext & context, const int count,
+  std::mt19937 & rng)
+{
+  const auto & grid = context.GetGrid();
+  std::vector<Cell> free_cells;
+  for (Cell cell = 0; cell < grid.GetCellCount(); ++cell) {
+    if (!context.GetCollisionMap().IsCellInCollision(cell)) {
+      free_cells.push_back(cell);
+    }
+  }
+  std::vector<Query> queries;
+  if (free_cells.empty()) {
+    return queries;
+  }
+  std::uniform_int_distribution<std::size_t> pick(0, free_cells.size() - 1);
+  for (int i = 0; i < count; ++i) {
+    queries.push_back(
+      {grid.CellToPoint(free_cells[pick(rng)]), grid.CellToPoint(free_cells[pick(rng)])});
+  }
+  return queries;
+}
+
+double GetPercentile(std::vector<double> values, const double & fraction)
+{
+  if (values.empty()) {
+    return 0.0;
+  }
+  const auto index = static_cast<std::size_t>(fraction * (values.size() - 1) + 0.5);
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+double GetPathLength(const std::vector<Point> & path)
+{
+  double length = 0.0;
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    length += (path[i] - path[i - 1]).norm();
+  }
+  return length;
+}
+
+// Plans one query, recording its latency and adding the cells it expanded to `expanded`
+template<typename Planner>
+std::vector<Point> RunQuery(
+  const PlannerParameters & parameters, const std::shared_ptr<const PlanningContext> & context,
+  const Query & query, std::vector<double> & latencies, std::size_t & expanded)
+{
+  const auto start_time = std::chrono::steady_clock::now();
+  Planner planner(parameters, context);
+  const auto path = planner.Plan(query.start, query.goal);
+  const auto end_time = std::chrono::steady_clock::now();
+
+  latencies.push_back(std::chrono::duration<double, std::milli>(end_time - start_time).count());
+  const auto & expanded_set = planner.GetExpandedSet();
+  expanded += std::count(expanded_set.begin(), expanded_set.end(), true);
+  return path;
+}
+
+// Like RunQuery, but with a planner that keeps its search state between queries
+std::vector<Point> RunIncrementalQuery(
+  DStarLitePlanner & planner, const std::shared_ptr<const PlanningContext> & context,
+  const Query & query, std::vector<double> & latencies, std::size_t & expanded)
+{
+  const auto start_time = std::chrono::steady_clock::now();
+  const auto path = planner.Plan(context, query.start, query.goal);
+  const auto end_time = std::chrono::steady_clock::now();
+
+  latencies.push_back(std::chrono::duration<double, std::milli>(end_time - start_time).count());
+  const auto & expanded_set = planner.GetExpandedSet();
+  expanded += std::count(expanded_set.begin(), expanded_set.end(), true);
+  return path;
+}
+
+void RunScenario(const Scenario & scenario, const Options & options, std::mt19937 & rng)
+{
+  const auto context = std::make_shared<PlanningContext>(
+    *scenario.costmap, options.grid_size, options.collision_radius);
+  const auto queries = MakeQueries(*context, options.query_count, rng);
+
+  std::printf(
+    "\n%s: %d x %d grid, %zu queries\n", scenario.name.c_str(), context->GetGrid().GetSizeX(),
+    context->GetGrid().GetSizeY(), queries.size());
+  std::printf(
+    "%-18s %7s %12s %14s %10s %9s %9s %10s\n", "mode", "solved", "expanded", "coll. checks",
+    "peak MB", "p50 ms", "p99 ms", "length m");
+
+  for (const auto & mode : options.modes) {
+    const auto use_radix_heap = mode == "astar_radix";
+    const auto replan = mode == "incremental_replan";
+    const auto incremental = mode == "incremental" || replan;
+    DStarLitePlanner incremental_planner;
+    PlannerParameters parameters;
+    parameters.planner_mode = use_radix_heap ? "astar" : mode;
+    parameters.cost_weight = options.cost_weight;
+
+    std::vector<double> latencies;
+    std::size_t solved = 0;
+    std::size_t expanded = 0;
+    std::size_t collision_checks = 0;
+    std::size_t peak_bytes = 0;
+    double total_length = 0.0;
+
+    for (auto query : queries) {
+      if (replan) {
+        // Untimed first plan, after which the robot has driven halfway along its path
+        const auto first_path = incremental_planner.Plan(context, query.start, query.goal);
+        if (first_path.empty()) {
+          continue;
+        }
+        query.start = first_path[first_path.size() / 2];
+      }
+
+      const auto checks_before = context->GetCollisionMap().GetCheckCount();
+      const auto baseline_bytes = current_heap_bytes.load();
+      peak_heap_bytes.store(baseline_bytes);
+
+      std::vector<Point> path;
+      if (incremental) {
+        path = RunIncrementalQuery(incremental_planner, context, query, latencies, expanded);
+      } else if (use_radix_heap) {
+        path = RunQuery<BasicAStarPathPlanner<RadixHeapFrontier>>(
+          parameters, context, query, latencies, expanded);
+      } else {
+        path = RunQuery<AStarPathPlanner>(parameters, context, query, latencies, expanded);
+      }
+      peak_bytes = std::max(peak_bytes, peak_heap_bytes.load() - baseline_bytes);
+      collision_checks += context->GetCollisionMap().GetCheckCount() - checks_before;
+      if (!path.empty()) {
+        ++solved;
+        total_length += GetPathLength(path);
+      }
+    }
+
+    const auto query_count = std::max<std::size_t>(queries.size(), 1);
+    std::printf(
+      "%-18s %7zu %12zu %14zu %10.2f %9.3f %9.3f %10.3f\n", mode.c_str(), solved,
+      expanded / query_count, collision_checks / query_count, peak_bytes / 1e6,
+      GetPercentile(latencies, 0.5), GetPercentile(latencies, 0.99),
+      solved > 0 ? total_length / solved : 0.0);
+  }
+}
+
+std::vector<std::string> SplitList(const std::string & list)
+{
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+bool ParseOptions(const int argc, char ** argv, Options & options)
+{
+  for (int i = 1; i < argc; ++i) {
+    const std::string flag = argv[i];
+    if (i + 1 >= argc) {
+      std::fprintf(stderr, "Missing value for %s\n", flag.c_str());
+      return false;
+    }
+    const std::string value = argv[++i];
+    if (flag == "--map") {
+      options.map_files.push_back(value);
+    } else if (flag == "--modes") {
+      options.modes = SplitList(value);
+    } else if (flag == "--queries") {
+      options.query_count = std::stoi(value);
+    } else if (flag == "--seed") {
+      options.seed = std::stoul(value);
+    } else if (flag == "--size") {
+      options.generated_size = std::stod(value);
+    } else if (flag == "--grid-size") {
+      options.grid_size = std::stod(value);
+    } else if (flag == "--collision-radius") {
+      options.collision_radius = std::stod(value);
+    } else if (flag == "--cost-weight") {
+      options.cost_weight = std::stod(value);
+    } else {
+      std::fprintf(stderr, "Unknown option %s\n", flag.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    return 1;
+  }
+
+  std::mt19937 rng(options.seed);
+  std::vector<Scenario> scenarios;
+  for (const auto & map_file : options.map_files) {
+    auto costmap = LoadMap(map_file);
+    if (!costmap) {
+      std::fprintf(stderr, "Could not load map %s\n", map_file.c_str());
+      return 1;
+    }
+    scenarios.push_back({map_file, costmap});
+  }
+  scenarios.push_back({"open field", MakeEmptyCostmap(options.generated_size)});
+  scenarios.push_back({"clutter", MakeClutterMap(options.generated_size, rng)});
+  scenarios.push_back({"maze", MakeMazeMap(options.generated_size, rng)});
+
+  for (const auto & scenario : scenarios) {
+    RunScenario(scenario, options, rng);
+  }
+  return 0;
+}
@@ -19,165 +19,383 @@
 // THE SOFTWARE.
 
 #include "astar_path_planner.hpp"
+#include "anytime_search.hpp"
+#include "bidirectional_search.hpp"
+#include "hierarchical_search.hpp"
+#include "jump_point_search.hpp"
+#include "theta_star_search.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
 #include <memory>
-#include <set>
+#include <optional>
 #include <vector>
 #include <queue>
+#include <string>
 
 namespace astar_path_planner
 {
 
-void AStarPathPlanner::DeclareParameters(rclcpp_lifecycle::LifecycleNode::SharedPtr node)
+template<typename Frontier>
+void BasicAStarPathPlanner<Frontier>::DeclareParameters(
+  rclcpp_lifecycle::LifecycleNode::SharedPtr node)
 {
-  node->declare_parameter("goal_threshold", 0.015);
+  const PlannerParameters defaults;
+  node->declare_parameter("goal_threshold", defaults.goal_threshold);
   node->declare_parameter("grid_size", 0.01);
   node->declare_parameter("collision_radius", 0.08);
+  node->declare_parameter("planner_mode", defaults.planner_mode);
+  node->declare_parameter("hierarchy_block_size", defaults.hierarchy_block_size);
+  node->declare_parameter("planning_deadline", defaults.planning_deadline);
+  node->declare_parameter("anytime_initial_weight", defaults.anytime_initial_weight);
+  node->declare_parameter("cost_weight", defaults.cost_weight);
 }
 
-AStarPathPlanner::AStarPathPlanner(
+template<typename Frontier>
+PlannerParameters BasicAStarPathPlanner<Frontier>::GetParameters(
+  rclcpp_lifecycle::LifecycleNode::SharedPtr node)
+{
+  PlannerParameters parameters;
+  parameters.goal_threshold = node->get_parameter("goal_threshold").as_double();
+  parameters.planner_mode = node->get_parameter("planner_mode").as_string();
+  parameters.hierarchy_block_size = node->get_parameter("hierarchy_block_size").as_int();
+  parameters.planning_deadline = node->get_parameter("planning_deadline").as_double();
+  parameters.anytime_initial_weight = node->get_parameter("anytime_initial_weight").as_double();
+  parameters.cost_weight = node->get_parameter("cost_weight").as_double();
+  return parameters;
+}
+
+template<typename Frontier>
+BasicAStarPathPlanner<Frontier>::BasicAStarPathPlanner(
   rclcpp_lifecycle::LifecycleNode::SharedPtr node,
-  std::shared_ptr<nav2_costmap_2d::Costmap2DROS> ros_costmap)
-: logger_(node->get_logger()),
-  ros_costmap_(ros_costmap)
+  std::shared_ptr<const PlanningContext> context)
+: BasicAStarPathPlanner(GetParameters(node), context, node->get_logger())
+{
+}
+
+template<typename Frontier>
+BasicAStarPathPlanner<Frontier>::BasicAStarPathPlanner(
+  const PlannerParameters & parameters, std::shared_ptr<const PlanningContext> context,
+  const rclcpp::Logger & logger)
+: logger_(logger),
+  goal_threshold_(parameters.goal_threshold),
+  planner_mode_(parameters.planner_mode),
+  hierarchy_block_size_(parameters.hierarchy_block_size),
+  planning_deadline_(parameters.planning_deadline),
+  anytime_initial_weight_(parameters.anytime_initial_weight),
+  suboptimality_bound_(1.0),
+  cost_scale_(MakeCostScaleTable(parameters.cost_weight)),
+  context_(context)
 {
-  goal_threshold_ = node->get_parameter("goal_threshold").as_double();
-  grid_size_ = node->get_parameter("grid_size").as_double();
-  collision_radius_ = node->get_parameter("collision_radius").as_double();
 }
 
-std::vector<Point> AStarPathPlanner::Plan(const Point & start, const Point & goal)
+template<typename Frontier>
+std::vector<Point> BasicAStarPathPlanner<Frontier>::Plan(const Point & start, const Point & goal)
 {
-  if (IsPointInCollision(goal)) {
+  const auto deadline = AnytimeSearch::Clock::now() +
+    std::chrono::duration_cast<AnytimeSearch::Clock::duration>(
+    std::chrono::duration<double>(planning_deadline_));
+  suboptimality_bound_ = 1.0;
+  if (planner_mode_ != "astar" && planner_mode_ != "bidirectional" && planner_mode_ != "jps" &&
+    planner_mode_ != "theta_star" && planner_mode_ != "hierarchical" && planner_mode_ != "anytime")
+  {
+    // "incremental" keeps its search between requests, so it lives in DStarLitePlanner instead
+    RCLCPP_ERROR(logger_, "Unsupported planner mode \"%s\".", planner_mode_.c_str());
+    return {};
+  }
+  if (planner_mode_ != "astar" && goal_threshold_ > 0.0) {
+    RCLCPP_INFO_ONCE(
+      logger_, "The \"%s\" planner mode ignores goal_threshold and searches to the goal's cell.",
+      planner_mode_.c_str());
+  }
+  const auto & grid = context_->GetGrid();
+  const auto & collision_map = context_->GetCollisionMap();
+
+  Cell start_cell;
+  if (!grid.PointToCell(start, start_cell)) {
+    RCLCPP_ERROR(
+      logger_, "Starting position (%f, %f) is outside of the costmap",
+      start.x(), start.y());
+    return {};
+  }
+
+  if (!grid.PointToCell(goal, goal_cell_)) {
+    RCLCPP_ERROR(logger_, "Provided goal position is outside of the costmap");
+    return {};
+  }
+
+  if (collision_map.IsCellInCollision(goal_cell_)) {
     RCLCPP_ERROR(logger_, "Provided goal position would cause a collision");
     return {};
   }
 
-  if (IsPointInCollision(start)) {
+  if (collision_map.IsCellInCollision(start_cell)) {
     RCLCPP_ERROR(
       logger_, "Starting position (%f, %f) is currently in a collision",
       start.x(), start.y());
     return {};
   }
 
-  expanded_.clear();
-  frontier_ = FrontierQueue{};
-
   goal_ = goal;
 
-  // BEGIN STUDENT CODE
+  if (planner_mode_ == "bidirectional" || planner_mode_ == "jps" ||
+    planner_mode_ == "theta_star")
+  {
+    std::vector<Cell> cells;
+    if (planner_mode_ == "bidirectional") {
+      cells = BidirectionalSearch(*context_, cost_scale_).Search(start_cell, goal_cell_, expanded_);
+    } else if (planner_mode_ == "jps") {
+      cells = JumpPointSearch(*context_).Search(start_cell, goal_cell_, expanded_);
+    } else {
+      cells = ThetaStarSearch(*context_).Search(start_cell, goal_cell_, expanded_);
+    }
+    if (cells.empty()) {
+      RCLCPP_ERROR(logger_, "No path found after exhausting search space.");
+      return {};
+    }
+    return CellsToPath(cells, start, goal);
+  }
 
-  frontier_.push({{start}, GetHeuristicCost(start)});
+  if (planner_mode_ == "anytime") {
+    AnytimeSearch search(*context_, cost_scale_, anytime_initial_weight_);
+    const auto cells = search.Search(start_cell, goal_cell_, deadline, expanded_);
+    if (cells.empty()) {
+      RCLCPP_ERROR(logger_, "No path found within the planning deadline.");
+      return {};
+    }
+    suboptimality_bound_ = search.GetSuboptimalityBound();
+    RCLCPP_INFO(
+      logger_, "Anytime search returned a path within %f of optimal.", suboptimality_bound_);
+    return CellsToPath(cells, start, goal);
+  }
+
+  if (planner_mode_ == "hierarchical") {
+    const auto cells = HierarchicalSearch(*context_, cost_scale_, hierarchy_block_size_).Search(
+      start_cell, goal_cell_, expanded_);
+    if (!cells.empty()) {
+      return CellsToPath(cells, start, goal);
+    }
+    RCLCPP_WARN(logger_, "Hierarchical search found no path. Falling back to a full search.");
+  }
+
+  expanded_.assign(grid.GetCellCount(), false);
+  frontier_ = FrontierQueue{};
+  path_costs_.assign(grid.GetCellCount(), std::numeric_limits<double>::infinity());
+  parents_.resize(grid.GetCellCount());
+
+  // BEGIN STUDENT CODE
+  path_costs_[start_cell] = 0.0;
+  parents_[start_cell] = start_cell;
+  frontier_.push({start_cell, GetHeuristicCost(start_cell), 0.0});
 
   while (!frontier_.empty()) {
     // Get next state to expand
     const auto entry = frontier_.top();
     frontier_.pop();
-    const auto path = entry.path;
-    const auto cost = entry.cost;
-    const auto last_state = path.back();
 
     // Skip if we've already expanded this state
-    if (expanded_.count(last_state) > 0) {
+    if (expanded_[entry.cell]) {
       continue;
     }
 
     // Add state to expanded set
-    expanded_.insert(last_state);
+    expanded_[entry.cell] = true;
 
     // Check if we've found our goal
-    if (IsGoal(last_state)) {
+    if (IsGoal(entry.cell)) {
+      auto path = ReconstructPath(entry.cell);
+      // Lattice points are cell centers, so pin the ends to the exact requested poses
+      path.front() = start;
+      if (path.size() > 1) {
+        path.back() = goal;
+      }
       return path;
     }
 
-    const auto neighbors = GetAdjacentPoints(last_state);
-
-    std::for_each(
-      neighbors.begin(), neighbors.end(), [this, &path, &cost](const auto & neighbor) {
-        ExtendPathAndAddToFrontier(path, cost, neighbor);
-      });
+    const auto x = grid.GetX(entry.cell);
+    const auto y = grid.GetY(entry.cell);
+    for (const auto & move : context_->GetMoves()) {
+      if (!grid.IsInBounds(x + move.dx, y + move.dy)) {
+        continue;
+      }
+      ExtendPathAndAddToFrontier(entry, entry.cell + move.offset, move);
+    }
   }
 
   RCLCPP_ERROR(logger_, "No path found after exhausting search space.");
+
   return {};
   // END STUDENT CODE
 }
 
-void AStarPathPlanner::ExtendPathAndAddToFrontier(
-  const std::vector<Point> & path, const double & path_cost,
-  const Point & next_point)
+template<typename Frontier>
+std::vector<std::vector<Point>> BasicAStarPathPlanner<Frontier>::PlanToGoals(
+  const Point & start,
+  const std::vector<Point> & goals)
 {
-  // BEGIN STUDENT CODE
-  std::vector<Point> new_path(path);
-  new_path.push_back(next_point);
-  const auto new_cost = path_cost - GetHeuristicCost(path.back()) +
-    GetStepCost(path.back(), next_point) + GetHeuristicCost(next_point);
-  frontier_.push({new_path, new_cost});
-  // END STUDENT CODE
+  MultiGoalSearch search(*context_, cost_scale_);
+  const auto goal_cells = SearchToGoals(start, goals, search);
+  std::vector<std::vector<Point>> paths(goals.size());
+  for (std::size_t i = 0; i < goal_cells.size(); ++i) {
+    if (!goal_cells[i]) {
+      continue;
+    }
+    const auto cells = search.GetPath(*goal_cells[i]);
+    if (!cells.empty()) {
+      paths[i] = CellsToPath(cells, start, goals[i]);
+    }
+  }
+  return paths;
 }
 
-std::vector<Point> AStarPathPlanner::GetAdjacentPoints(const Point & point)
+template<typename Frontier>
+std::vector<double> BasicAStarPathPlanner<Frontier>::GetPathCosts(
+  const Point & start,
+  const std::vector<Point> & goals)
 {
-  // BEGIN STUDENT CODE
-  std::vector<Point> neighbors;
-
-  for (auto dx = -grid_size_; dx <= grid_size_; dx += grid_size_) {
-    for (auto dy = -grid_size_; dy <= grid_size_; dy += grid_size_) {
-      if (std::abs(dx) < 1e-4 && std::abs(dy) < 1e-4) {
-        continue;
-      }
-      const Point neighbor = point + Point{dx, dy};
-      if (!IsPointInCollision(neighbor)) {
-        neighbors.push_back(neighbor);
-      }
+  MultiGoalSearch search(*context_, cost_scale_);
+  const auto goal_cells = SearchToGoals(start, goals, search);
+  std::vector<double> costs(goals.size(), std::numeric_limits<double>::infinity());
+  for (std::size_t i = 0; i < goal_cells.size(); ++i) {
+    if (goal_cells[i]) {
+      costs[i] = search.GetPathCost(*goal_cells[i]);
     }
   }
-  return neighbors;
-  // END STUDENT CODE
+  return costs;
 }
 
+template<typename Frontier>
+std::vector<std::optional<Cell>> BasicAStarPathPlanner<Frontier>::SearchToGoals(
+  const Point & start, const std::vector<Point> & goals,
+  MultiGoalSearch & search)
+{
+  const auto & grid = context_->GetGrid();
+  const auto & collision_map = context_->GetCollisionMap();
+
+  Cell start_cell;
+  if (!grid.PointToCell(start, start_cell)) {
+    RCLCPP_ERROR(
+      logger_, "Starting position (%f, %f) is outside of the costmap",
+      start.x(), start.y());
+    return {};
+  }
+
+  if (collision_map.IsCellInCollision(start_cell)) {
+    RCLCPP_ERROR(
+      logger_, "Starting position (%f, %f) is currently in a collision",
+      start.x(), start.y());
+    return {};
+  }
+
+  std::vector<std::optional<Cell>> goal_cells(goals.size());
+  std::vector<Cell> valid_goal_cells;
+  for (std::size_t i = 0; i < goals.size(); ++i) {
+    Cell goal_cell;
+    if (!grid.PointToCell(goals[i], goal_cell)) {
+      RCLCPP_WARN(
+        logger_, "Goal position (%f, %f) is outside of the costmap",
+        goals[i].x(), goals[i].y());
+      continue;
+    }
+    if (collision_map.IsCellInCollision(goal_cell)) {
+      RCLCPP_WARN(
+        logger_, "Goal position (%f, %f) would cause a collision",
+        goals[i].x(), goals[i].y());
+      continue;
+    }
+    goal_cells[i] = goal_cell;
+    valid_goal_cells.push_back(goal_cell);
+  }
+
+  search.Search(start_cell, valid_goal_cells, expanded_);
+  return goal_cells;
+}
 
-double AStarPathPlanner::GetHeuristicCost(const Point & point)
+template<typename Frontier>
+void BasicAStarPathPlanner<Frontier>::ExtendPathAndAddToFrontier(
+  const FrontierEntry & entry, const Cell & next_cell,
+  const GridMove & move)
 {
   // BEGIN STUDENT CODE
-  return (point - goal_).norm();
+  if (expanded_[next_cell]) {
+    return;
+  }
+
+  const auto new_path_cost = entry.path_cost + GetStepCost(next_cell, move);
+  if (new_path_cost >= path_costs_[next_cell]) {
+    return;
+  }
+
+  if (context_->GetCollisionMap().IsCellInCollision(next_cell)) {
+    return;
+  }
+
+  path_costs_[next_cell] = new_path_cost;
+  parents_[next_cell] = entry.cell;
+  frontier_.push({next_cell, new_path_cost + GetHeuristicCost(next_cell), new_path_cost});
   // END STUDENT CODE
 }
 
-double AStarPathPlanner::GetStepCost(const Point & point, const Point & next)
+template<typename Frontier>
+std::vector<Point> BasicAStarPathPlanner<Frontier>::ReconstructPath(Cell cell)
+{
+  std::vector<Point> path;
+  // The start cell is its own parent
+  while (parents_[cell] != cell) {
+    path.push_back(GetGrid().CellToPoint(cell));
+    cell = parents_[cell];
+  }
+  path.push_back(GetGrid().CellToPoint(cell));
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+template<typename Frontier>
+std::vector<Point> BasicAStarPathPlanner<Frontier>::CellsToPath(
+  const std::vector<Cell> & cells, const Point & start,
+  const Point & goal) const
+{
+  std::vector<Point> path;
+  path.reserve(cells.size());
+  for (const auto & cell : cells) {
+    path.push_back(GetGrid().CellToPoint(cell));
+  }
+  path.front() = start;
+  if (path.size() > 1) {
+    path.back() = goal;
+  }
+  return path;
+}
+
+template<typename Frontier>
+double BasicAStarPathPlanner<Frontier>::GetHeuristicCost(const Cell & cell)
 {
   // BEGIN STUDENT CODE
-  return (next - point).norm();
+  return (GetGrid().CellToPoint(cell) - goal_).norm();
   // END STUDENT CODE
 }
 
-bool AStarPathPlanner::IsGoal(const Point & point)
+template<typename Frontier>
+double BasicAStarPathPlanner<Frontier>::GetStepCost(const Cell & next_cell, const GridMove & move)
 {
   // BEGIN STUDENT CODE
-  return (point - goal_).norm() < goal_threshold_;
+  return move.distance * cost_scale_[context_->GetCellCost(next_cell)];
   // END STUDENT CODE
 }
 
-bool AStarPathPlanner::IsPointInCollision(const Point & point)
+template<typename Frontier>
+bool BasicAStarPathPlanner<Frontier>::IsGoal(const Cell & cell)
 {
-  auto costmap = ros_costmap_->getCostmap();
-
-  const auto polygon = PolygonForCircle(*costmap, point, collision_radius_);
-
-  std::vector<nav2_costmap_2d::MapLocation> map_cells;
-  costmap->convexFillCells(polygon, map_cells);
-
-  auto is_cell_lethal = [&costmap](const auto & cell) {
-      if (cell.x < 0 || cell.y < 0 || cell.x >= costmap->getSizeInCellsX() ||
-        cell.y >= costmap->getSizeInCellsY())
-      {
-        // out of bounds cells are assumed to be empty
-        return false;
-      }
-      const auto cost = costmap->getCost(cell.x, cell.y);
-      return cost == nav2_costmap_2d::LETHAL_OBSTACLE;
-    };
-
-  return std::any_of(map_cells.begin(), map_cells.end(), is_cell_lethal);
+  // BEGIN STUDENT CODE
+  if (cell == goal_cell_) {
+    return true;
+  }
+  return (GetGrid().CellToPoint(cell) - goal_).norm() < goal_threshold_;
+  // END STUDENT CODE
 }
 
+template class BasicAStarPathPlanner<BinaryHeapFrontier>;
+template class BasicAStarPathPlanner<RadixHeapFrontier>;
+
 }  // namespace astar_path_planner
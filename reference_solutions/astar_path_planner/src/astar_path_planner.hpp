@@ -21,61 +21,158 @@
 #define ASTAR_PATH_PLANNER_HPP_
 
 #include <memory>
+#include <optional>
 #include <queue>
-#include <unordered_set>
+#include <string>
 #include <vector>
-#include <nav2_costmap_2d/costmap_2d_ros.hpp>
 #include <rclcpp_lifecycle/lifecycle_node.hpp>
+#include "multi_goal_search.hpp"
+#include "planning_context.hpp"
+#include "radix_heap_frontier.hpp"
+#include "search_grid.hpp"
 #include "utils.hpp"
 
 namespace astar_path_planner
 {
 
-class AStarPathPlanner
+// Settings read from the planner's ROS parameters, with the same defaults they are declared with
+struct PlannerParameters
+{
+  // Distance from the goal at which the search may stop. Only the "astar" mode and the
+  // "hierarchical" mode's fallback search use it. The other modes always search to the goal's cell.
+  double goal_threshold = 0.015;
+  // "astar" plans each request from scratch, "bidirectional" searches from both ends, "jps"
+  // prunes symmetric paths with Jump Point Search, "theta_star" returns sparse any-angle waypoints,
+  // "hierarchical" refines a coarse route over blocks of cells, "anytime" improves a weighted A*
+  // path until the deadline and "incremental" reuses search effort between requests
+  std::string planner_mode = "astar";
+  // Width of the blocks used by the "hierarchical" mode's coarse search, in grid cells
+  int hierarchy_block_size = 32;
+  // Time limit in seconds for the "anytime" mode, which starts with the given heuristic weight
+  double planning_deadline = 0.1;
+  double anytime_initial_weight = 3.0;
+  // Extra cost per meter for driving through inflated space, relative to free space. Used by the
+  // "astar", "bidirectional", "hierarchical" and "anytime" modes and the one-to-many API.
+  double cost_weight = 0.0;
+
+  // Compares every field above, so keep it in step with them
+  bool operator==(const PlannerParameters & other) const
+  {
+    return goal_threshold == other.goal_threshold && planner_mode == other.planner_mode &&
+           hierarchy_block_size == other.hierarchy_block_size &&
+           planning_deadline == other.planning_deadline &&
+           anytime_initial_weight == other.anytime_initial_weight &&
+           cost_weight == other.cost_weight;
+  }
+
+  bool operator!=(const PlannerParameters & other) const
+  {
+    return !(*this == other);
+  }
+};
+
+using BinaryHeapFrontier = std::priority_queue<FrontierEntry, std::vector<FrontierEntry>,
+    FrontierEntryComparator>;
+
+// Grid planner with the frontier used by the "astar" mode's search as a template parameter. Both
+// BinaryHeapFrontier and RadixHeapFrontier are instantiated in astar_path_planner.cpp.
+template<typename Frontier = BinaryHeapFrontier>
+class BasicAStarPathPlanner
 {
 public:
-  using FrontierQueue = std::priority_queue<FrontierEntry, std::vector<FrontierEntry>,
-      FrontierEntryComparator>;
-  using ExpandedSet = std::unordered_set<Point, PointHash, PointEqualityComparator>;
+  using FrontierQueue = Frontier;
+  // One bit per grid cell, set once the cell has been expanded
+  using ExpandedSet = std::vector<bool>;
 
   static void DeclareParameters(rclcpp_lifecycle::LifecycleNode::SharedPtr node);
 
-  AStarPathPlanner(
+  static PlannerParameters GetParameters(rclcpp_lifecycle::LifecycleNode::SharedPtr node);
+
+  BasicAStarPathPlanner(
     rclcpp_lifecycle::LifecycleNode::SharedPtr node,
-    std::shared_ptr<nav2_costmap_2d::Costmap2DROS> ros_costmap);
+    std::shared_ptr<const PlanningContext> context);
+
+  // Constructs a planner without a node, for use outside of the planner server
+  BasicAStarPathPlanner(
+    const PlannerParameters & parameters, std::shared_ptr<const PlanningContext> context,
+    const rclcpp::Logger & logger = rclcpp::get_logger("astar_path_planner"));
 
   std::vector<Point> Plan(const Point & start, const Point & goal);
 
+  // Plans from start to every goal with a single search. Paths to goals that are outside the
+  // costmap, in collision or unreachable are empty.
+  std::vector<std::vector<Point>> PlanToGoals(
+    const Point & start,
+    const std::vector<Point> & goals);
+
+  // Grid path cost from start to every goal from a single search. Goals that are outside the
+  // costmap, in collision or unreachable cost infinity.
+  std::vector<double> GetPathCosts(const Point & start, const std::vector<Point> & goals);
+
   const ExpandedSet & GetExpandedSet() const
   {
     return expanded_;
   }
 
+  const SearchGrid & GetGrid() const
+  {
+    return context_->GetGrid();
+  }
+
+  // Upper bound on the last path's cost divided by the optimal cost, as proven by the "anytime"
+  // mode. Other modes leave it at 1.
+  double GetSuboptimalityBound() const
+  {
+    return suboptimality_bound_;
+  }
+
 private:
   rclcpp::Logger logger_;
   Point goal_;
   double goal_threshold_;
-  double grid_size_;
-  double collision_radius_;
-  std::shared_ptr<nav2_costmap_2d::Costmap2DROS> ros_costmap_;
+  std::string planner_mode_;
+  int hierarchy_block_size_;
+  double planning_deadline_;
+  double anytime_initial_weight_;
+  double suboptimality_bound_;
+  CostScaleTable cost_scale_;
+  std::shared_ptr<const PlanningContext> context_;
+  Cell goal_cell_;
   ExpandedSet expanded_;
   FrontierQueue frontier_;
+  // Per-cell cheapest known cost from the start and the cell it was reached from
+  std::vector<double> path_costs_;
+  std::vector<Cell> parents_;
 
   void ExtendPathAndAddToFrontier(
-    const std::vector<Point> & path, const double & path_cost,
-    const Point & next_point);
+    const FrontierEntry & entry, const Cell & next_cell,
+    const GridMove & move);
+
+  std::vector<Point> ReconstructPath(Cell cell);
 
-  std::vector<Point> GetAdjacentPoints(const Point & point);
+  // Runs a one-to-many search and returns each goal's cell, or nullopt for goals that can't be
+  // planned to. Returns an empty vector if the start is invalid.
+  std::vector<std::optional<Cell>> SearchToGoals(
+    const Point & start, const std::vector<Point> & goals,
+    MultiGoalSearch & search);
 
-  double GetHeuristicCost(const Point & point);
+  // Converts a cell path from one of the alternative searches, pinning the ends like A* does
+  std::vector<Point> CellsToPath(
+    const std::vector<Cell> & cells, const Point & start,
+    const Point & goal) const;
 
-  double GetStepCost(const Point & point, const Point & next);
+  double GetHeuristicCost(const Cell & cell);
 
-  bool IsGoal(const Point & point);
+  double GetStepCost(const Cell & next_cell, const GridMove & move);
 
-  bool IsPointInCollision(const Point & point);
+  bool IsGoal(const Cell & cell);
 };
 
+extern template class BasicAStarPathPlanner<BinaryHeapFrontier>;
+extern template class BasicAStarPathPlanner<RadixHeapFrontier>;
+
+using AStarPathPlanner = BasicAStarPathPlanner<>;
+
 }  // namespace astar_path_planner
 
 #endif  // ASTAR_PATH_PLANNER_HPP_
@@ -18,14 +18,19 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <nav2_core/global_planner.hpp>
 #include <pluginlib/class_list_macros.hpp>
-#include <visualization_msgs/msg/marker.hpp>
 #include <tf2_eigen/tf2_eigen.hpp>
 #include "astar_path_planner.hpp"
+#include "dstar_lite_planner.hpp"
+#include "expanded_set_publisher.hpp"
+#include "plan_cache.hpp"
 
 namespace astar_path_planner
 {
@@ -46,12 +51,32 @@ public:
     global_frame_ = costmap_ros->getGlobalFrameID();
     costmap_ros_ = costmap_ros;
     AStarPathPlanner::DeclareParameters(node_shared);
-    expanded_viz_pub_ = node_shared->create_publisher<visualization_msgs::msg::Marker>(
+    node_shared->declare_parameter("expanded_viz_decimation", 1);
+    node_shared->declare_parameter("expanded_viz_max_rate", 2.0);
+    node_shared->declare_parameter("plan_cache_size", 8);
+    node_shared->declare_parameter("plan_cache_rejoin_distance", 0.05);
+    const auto plan_cache_size = node_shared->get_parameter("plan_cache_size").as_int();
+    if (plan_cache_size < 0) {
+      RCLCPP_WARN(
+        node_shared->get_logger(), "plan_cache_size is negative (%ld). Disabling the plan cache.",
+        static_cast<long>(plan_cache_size));
+    }
+    plan_cache_ = std::make_unique<PlanCache>(std::max<std::int64_t>(plan_cache_size, 0));
+    expanded_viz_pub_ = node_shared->create_publisher<nav_msgs::msg::OccupancyGrid>(
       "~/expanded_viz",
       rclcpp::SystemDefaultsQoS());
+    expanded_set_publisher_ = std::make_unique<ExpandedSetPublisher>(
+      expanded_viz_pub_, global_frame_,
+      node_shared->get_parameter("expanded_viz_max_rate").as_double());
   }
 
-  void cleanup() override {}
+  void cleanup() override
+  {
+    expanded_set_publisher_.reset();
+    planning_context_.reset();
+    incremental_planner_.reset();
+    plan_cache_->Clear();
+  }
 
   void activate() override
   {
@@ -96,11 +121,39 @@ public:
       node_shared->get_logger(), "Calculating path from (%f, %f) to (%f, %f)",
       start_point.x(), start_point.y(), goal_point.x(), goal_point.y());
 
-    AStarPathPlanner planner(node_shared, costmap_ros_);
-
-    const auto point_path = planner.Plan(start_point, goal_point);
-
-    PublishExpandedViz(planner.GetExpandedSet());
+    const auto context = GetPlanningContext(node_shared);
+    std::vector<Point> point_path;
+
+    if (node_shared->get_parameter("planner_mode").as_string() == "incremental") {
+      if (!incremental_planner_) {
+        incremental_planner_ = std::make_unique<DStarLitePlanner>(node_shared);
+      }
+      point_path = incremental_planner_->Plan(context, start_point, goal_point);
+      PublishExpandedViz(node_shared, incremental_planner_->GetExpandedSet(), context->GetGrid());
+    } else {
+      // Drop any incremental search state so it isn't stale if that mode is re-enabled
+      incremental_planner_.reset();
+      const auto parameters = AStarPathPlanner::GetParameters(node_shared);
+      // Cached plans were made with the old settings
+      if (parameters != plan_cache_parameters_) {
+        plan_cache_->Clear();
+        plan_cache_parameters_ = parameters;
+      }
+      point_path = plan_cache_->Lookup(
+        *context, planning_context_revision_, start_point, goal_point,
+        node_shared->get_parameter("plan_cache_rejoin_distance").as_double());
+      if (!point_path.empty()) {
+        RCLCPP_INFO(node_shared->get_logger(), "Reusing cached plan to this goal.");
+      } else {
+        AStarPathPlanner planner(parameters, context, node_shared->get_logger());
+        point_path = planner.Plan(start_point, goal_point);
+        PublishExpandedViz(node_shared, planner.GetExpandedSet(), planner.GetGrid());
+        // Anytime paths cut short by the deadline could be improved on by the next request
+        if (planner.GetSuboptimalityBound() <= 1.0) {
+          plan_cache_->Insert(*context, planning_context_revision_, point_path);
+        }
+      }
+    }
 
     if (point_path.empty()) {
       RCLCPP_ERROR(node_shared->get_logger(), "Could not find path!");
@@ -134,44 +187,41 @@ private:
   rclcpp_lifecycle::LifecycleNode::WeakPtr node_;
   std::string global_frame_;
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_;
-  rclcpp_lifecycle::LifecyclePublisher<visualization_msgs::msg::Marker>::SharedPtr
-    expanded_viz_pub_;
-
-
-  void PublishExpandedViz(const AStarPathPlanner::ExpandedSet & expanded)
+  ExpandedSetPublisher::Publisher::SharedPtr expanded_viz_pub_;
+  std::unique_ptr<ExpandedSetPublisher> expanded_set_publisher_;
+  // Reused across plans until the costmap contents or planner parameters change
+  std::shared_ptr<const PlanningContext> planning_context_;
+  // Incremented every time the planning context is rebuilt
+  std::size_t planning_context_revision_ = 0;
+  std::unique_ptr<PlanCache> plan_cache_;
+  // Settings the cached plans were made with
+  PlannerParameters plan_cache_parameters_;
+  std::unique_ptr<DStarLitePlanner> incremental_planner_;
+
+  std::shared_ptr<const PlanningContext> GetPlanningContext(
+    const rclcpp_lifecycle::LifecycleNode::SharedPtr & node)
   {
-    auto node_shared = node_.lock();
-    if (!node_shared) {
-      throw std::runtime_error{"Could not acquire node."};
+    const auto grid_size = node->get_parameter("grid_size").as_double();
+    const auto collision_radius = node->get_parameter("collision_radius").as_double();
+
+    auto costmap = costmap_ros_->getCostmap();
+    std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(costmap->getMutex()));
+    if (!planning_context_ ||
+      !planning_context_->IsValidFor(*costmap, grid_size, collision_radius))
+    {
+      RCLCPP_INFO(node->get_logger(), "Costmap changed. Rebuilding planning context.");
+      planning_context_ = std::make_shared<PlanningContext>(*costmap, grid_size, collision_radius);
+      ++planning_context_revision_;
     }
+    return planning_context_;
+  }
 
-    visualization_msgs::msg::Marker msg;
-
-    msg.header.frame_id = "map";
-    msg.header.stamp = node_shared->now();
-    msg.ns = "/planner/expanded";
-    msg.id = 0;
-    msg.type = visualization_msgs::msg::Marker::POINTS;
-    msg.action = visualization_msgs::msg::Marker::ADD;
-
-    msg.scale.x = 0.005;
-    msg.scale.y = 0.005;
-    msg.scale.z = 0.005;
-
-    msg.color.r = 0.0;
-    msg.color.g = 0.0;
-    msg.color.b = 1.0;
-    msg.color.a = 0.33;
-
-    std::transform(
-      expanded.begin(), expanded.end(), std::back_inserter(msg.points), [](const auto & p) {
-        geometry_msgs::msg::Point out;
-        out.x = p.x();
-        out.y = p.y();
-        return out;
-      });
-
-    expanded_viz_pub_->publish(msg);
+  void PublishExpandedViz(
+    const rclcpp_lifecycle::LifecycleNode::SharedPtr & node,
+    const std::vector<bool> & expanded, const SearchGrid & grid)
+  {
+    expanded_set_publisher_->Publish(
+      expanded, grid, node->now(), node->get_parameter("expanded_viz_decimation").as_int());
   }
 };
 
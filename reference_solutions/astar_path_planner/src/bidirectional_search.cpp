@@ -0,0 +1,173 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "bidirectional_search.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace astar_path_planner
+{
+
+BidirectionalSearch::BidirectionalSearch(
+  const PlanningContext & context,
+  const CostScaleTable & cost_scale)
+: context_(context),
+  cost_scale_(cost_scale)
+{
+}
+
+std::vector<Cell> BidirectionalSearch::Search(
+  const Cell & start, const Cell & goal,
+  std::vector<bool> & expanded)
+{
+  const auto cell_count = context_.GetGrid().GetCellCount();
+  start_ = start;
+  goal_ = goal;
+  best_cost_ = std::numeric_limits<double>::infinity();
+  meeting_cell_ = start;
+
+  const std::array<Cell, 2> roots{start, goal};
+  for (const auto direction : {kForward, kReverse}) {
+    frontiers_[direction] = FrontierQueue{};
+    path_costs_[direction].assign(cell_count, std::numeric_limits<double>::infinity());
+    parents_[direction].resize(cell_count);
+    expanded_[direction].assign(cell_count, false);
+
+    const auto root = roots[direction];
+    path_costs_[direction][root] = 0.0;
+    parents_[direction][root] = root;
+    frontiers_[direction].push({root, GetHeuristicCost(direction, root), 0.0});
+  }
+
+  if (start == goal) {
+    best_cost_ = 0.0;
+  }
+
+  while (true) {
+    SkipExpanded(kForward);
+    SkipExpanded(kReverse);
+    if (frontiers_[kForward].empty() || frontiers_[kReverse].empty()) {
+      break;
+    }
+    // Any cheaper path would have to pass through an unexpanded cell on both frontiers
+    const auto forward_key = frontiers_[kForward].top().cost;
+    const auto reverse_key = frontiers_[kReverse].top().cost;
+    if (std::max(forward_key, reverse_key) >= best_cost_) {
+      break;
+    }
+    Expand(frontiers_[kForward].size() <= frontiers_[kReverse].size() ? kForward : kReverse);
+  }
+
+  expanded.assign(cell_count, false);
+  for (std::size_t cell = 0; cell < cell_count; ++cell) {
+    expanded[cell] = expanded_[kForward][cell] || expanded_[kReverse][cell];
+  }
+
+  if (best_cost_ == std::numeric_limits<double>::infinity()) {
+    return {};
+  }
+  return ReconstructPath();
+}
+
+void BidirectionalSearch::Expand(const Direction direction)
+{
+  const auto & grid = context_.GetGrid();
+  const auto & collision_map = context_.GetCollisionMap();
+  const auto other = direction == kForward ? kReverse : kForward;
+  auto & frontier = frontiers_[direction];
+  auto & path_costs = path_costs_[direction];
+
+  const auto entry = frontier.top();
+  frontier.pop();
+  expanded_[direction][entry.cell] = true;
+
+  const auto x = grid.GetX(entry.cell);
+  const auto y = grid.GetY(entry.cell);
+  for (const auto & move : context_.GetMoves()) {
+    if (!grid.IsInBounds(x + move.dx, y + move.dy)) {
+      continue;
+    }
+    const Cell next_cell = entry.cell + move.offset;
+    if (expanded_[direction][next_cell] || collision_map.IsCellInCollision(next_cell)) {
+      continue;
+    }
+    // A move is priced by the cell it enters, which for the reverse search is the expanded cell
+    const auto entered_cell = direction == kForward ? next_cell : entry.cell;
+    const auto new_path_cost =
+      entry.path_cost + move.distance * cost_scale_[context_.GetCellCost(entered_cell)];
+    if (new_path_cost >= path_costs[next_cell]) {
+      continue;
+    }
+    path_costs[next_cell] = new_path_cost;
+    parents_[direction][next_cell] = entry.cell;
+    frontier.push(
+      {next_cell, new_path_cost + GetHeuristicCost(direction, next_cell), new_path_cost});
+
+    const auto meeting_cost = new_path_cost + path_costs_[other][next_cell];
+    if (meeting_cost < best_cost_) {
+      best_cost_ = meeting_cost;
+      meeting_cell_ = next_cell;
+    }
+  }
+}
+
+void BidirectionalSearch::SkipExpanded(const Direction direction)
+{
+  auto & frontier = frontiers_[direction];
+  while (!frontier.empty() && expanded_[direction][frontier.top().cell]) {
+    frontier.pop();
+  }
+}
+
+double BidirectionalSearch::GetHeuristicCost(const Direction direction, const Cell & cell) const
+{
+  return GetDistance(cell, direction == kForward ? goal_ : start_);
+}
+
+double BidirectionalSearch::GetDistance(const Cell & from, const Cell & to) const
+{
+  const auto & grid = context_.GetGrid();
+  const auto dx = grid.GetX(to) - grid.GetX(from);
+  const auto dy = grid.GetY(to) - grid.GetY(from);
+  return grid.GetGridSize() * std::hypot(dx, dy);
+}
+
+std::vector<Cell> BidirectionalSearch::ReconstructPath() const
+{
+  std::vector<Cell> path;
+  auto cell = meeting_cell_;
+  while (parents_[kForward][cell] != cell) {
+    path.push_back(cell);
+    cell = parents_[kForward][cell];
+  }
+  path.push_back(cell);
+  std::reverse(path.begin(), path.end());
+
+  cell = meeting_cell_;
+  while (parents_[kReverse][cell] != cell) {
+    cell = parents_[kReverse][cell];
+    path.push_back(cell);
+  }
+  return path;
+}
+
+}  // namespace astar_path_planner
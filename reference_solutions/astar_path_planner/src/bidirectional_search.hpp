@@ -0,0 +1,78 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef BIDIRECTIONAL_SEARCH_HPP_
+#define BIDIRECTIONAL_SEARCH_HPP_
+
+#include <array>
+#include <queue>
+#include <vector>
+#include "planning_context.hpp"
+#include "search_grid.hpp"
+#include "utils.hpp"
+
+namespace astar_path_planner
+{
+
+// Bidirectional A* over the search grid, growing one search from the start and one from the goal.
+// Each search is guided by the distance to the other end and the smaller frontier is expanded
+// next. The best meeting point is optimal once either frontier's smallest key reaches its cost.
+class BidirectionalSearch
+{
+public:
+  BidirectionalSearch(const PlanningContext & context, const CostScaleTable & cost_scale);
+
+  // Returns the cells of an optimal path from start to goal, or an empty vector if there is none.
+  // Cells expanded by either search are marked in `expanded`.
+  std::vector<Cell> Search(const Cell & start, const Cell & goal, std::vector<bool> & expanded);
+
+private:
+  using FrontierQueue = std::priority_queue<FrontierEntry, std::vector<FrontierEntry>,
+      FrontierEntryComparator>;
+
+  enum Direction { kForward = 0, kReverse = 1 };
+
+  const PlanningContext & context_;
+  const CostScaleTable & cost_scale_;
+  Cell start_;
+  Cell goal_;
+  std::array<FrontierQueue, 2> frontiers_;
+  std::array<std::vector<double>, 2> path_costs_;
+  std::array<std::vector<Cell>, 2> parents_;
+  std::array<std::vector<bool>, 2> expanded_;
+  double best_cost_;
+  Cell meeting_cell_;
+
+  // Expands the top of one frontier and records any improved meeting point with the other search
+  void Expand(const Direction direction);
+
+  // Drops entries for cells that were already expanded from the top of a frontier
+  void SkipExpanded(const Direction direction);
+
+  double GetHeuristicCost(const Direction direction, const Cell & cell) const;
+
+  double GetDistance(const Cell & from, const Cell & to) const;
+
+  std::vector<Cell> ReconstructPath() const;
+};
+
+}  // namespace astar_path_planner
+
+#endif  // BIDIRECTIONAL_SEARCH_HPP_
@@ -0,0 +1,141 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "collision_map.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace astar_path_planner
+{
+
+namespace
+{
+
+// One dimensional squared Euclidean distance transform of a sampled function, following
+// Felzenszwalb & Huttenlocher, "Distance Transforms of Sampled Functions" (2012).
+// Reads `count` samples from `values` with the given stride and writes the result back in place.
+// `samples` and `parabolas` are scratch buffers with room for count entries, `boundaries` for
+// count + 1 entries.
+void DistanceTransform1D(
+  double * values, const int count, const int stride, std::vector<double> & samples,
+  std::vector<int> & parabolas, std::vector<double> & boundaries)
+{
+  constexpr auto kInfinity = std::numeric_limits<double>::infinity();
+
+  for (int i = 0; i < count; ++i) {
+    samples[i] = values[i * stride];
+  }
+
+  int k = -1;
+  for (int q = 0; q < count; ++q) {
+    if (std::isinf(samples[q])) {
+      continue;
+    }
+    double s = -kInfinity;
+    while (k >= 0) {
+      const auto p = parabolas[k];
+      s = ((samples[q] + q * q) - (samples[p] + p * p)) / (2.0 * (q - p));
+      if (s > boundaries[k]) {
+        break;
+      }
+      --k;
+    }
+    ++k;
+    parabolas[k] = q;
+    boundaries[k] = k == 0 ? -kInfinity : s;
+    boundaries[k + 1] = kInfinity;
+  }
+
+  if (k < 0) {
+    // No finite samples, so every output stays infinite
+    return;
+  }
+
+  int j = 0;
+  for (int q = 0; q < count; ++q) {
+    while (boundaries[j + 1] < q) {
+      ++j;
+    }
+    const auto p = parabolas[j];
+    values[q * stride] = (q - p) * (q - p) + samples[p];
+  }
+}
+
+}  // namespace
+
+CollisionMap::CollisionMap(
+  const nav2_costmap_2d::Costmap2D & costmap, const SearchGrid & grid,
+  const double & collision_radius)
+{
+  const auto size_x = grid.GetSizeX();
+  const auto size_y = grid.GetSizeY();
+  const auto grid_size = grid.GetGridSize();
+
+  // Squared distance, in cells, to the nearest lethal grid cell. Lethal cells seed the transform
+  // with zero. A grid cell is lethal if it overlaps any lethal costmap cell.
+  std::vector<double> distances(grid.GetCellCount(), std::numeric_limits<double>::infinity());
+
+  const auto resolution = costmap.getResolution();
+  const auto cells_per_map_cell = resolution / grid_size;
+  for (unsigned int my = 0; my < costmap.getSizeInCellsY(); ++my) {
+    for (unsigned int mx = 0; mx < costmap.getSizeInCellsX(); ++mx) {
+      if (costmap.getCost(mx, my) != nav2_costmap_2d::LETHAL_OBSTACLE) {
+        continue;
+      }
+      const auto min_x = std::max(0, static_cast<int>(std::floor(mx * cells_per_map_cell)));
+      const auto min_y = std::max(0, static_cast<int>(std::floor(my * cells_per_map_cell)));
+      const auto max_x = std::min(
+        size_x - 1, static_cast<int>(std::ceil((mx + 1) * cells_per_map_cell)) - 1);
+      const auto max_y = std::min(
+        size_y - 1, static_cast<int>(std::ceil((my + 1) * cells_per_map_cell)) - 1);
+      for (int y = min_y; y <= max_y; ++y) {
+        for (int x = min_x; x <= max_x; ++x) {
+          distances[grid.GetCell(x, y)] = 0.0;
+        }
+      }
+    }
+  }
+
+  const auto max_dimension = std::max(size_x, size_y);
+  std::vector<double> samples(max_dimension);
+  std::vector<int> parabolas(max_dimension);
+  std::vector<double> boundaries(max_dimension + 1);
+
+  for (int x = 0; x < size_x; ++x) {
+    DistanceTransform1D(&distances[x], size_y, size_x, samples, parabolas, boundaries);
+  }
+  for (int y = 0; y < size_y; ++y) {
+    DistanceTransform1D(
+      &distances[grid.GetCell(0, y)], size_x, 1, samples, parabolas, boundaries);
+  }
+
+  // Pad by half a cell so obstacles that only graze the robot's footprint still count
+  const auto radius_in_cells = (collision_radius / grid_size) + 0.5;
+  const auto threshold = radius_in_cells * radius_in_cells;
+  collision_.resize(distances.size());
+  std::transform(
+    distances.begin(), distances.end(), collision_.begin(), [threshold](const double & d) {
+      return static_cast<std::uint8_t>(d <= threshold);
+    });
+}
+
+}  // namespace astar_path_planner
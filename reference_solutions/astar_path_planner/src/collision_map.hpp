@@ -0,0 +1,71 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef COLLISION_MAP_HPP_
+#define COLLISION_MAP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <nav2_costmap_2d/costmap_2d.hpp>
+#include "search_grid.hpp"
+
+namespace astar_path_planner
+{
+
+// Per-cell collision flags for a circular robot, precomputed over a SearchGrid.
+// A cell is in collision when a lethal costmap cell lies within the collision radius of its
+// center, which is found with a Euclidean distance transform over the grid.
+class CollisionMap
+{
+public:
+  CollisionMap() = default;
+
+  CollisionMap(
+    const nav2_costmap_2d::Costmap2D & costmap, const SearchGrid & grid,
+    const double & collision_radius);
+
+  bool IsCellInCollision(const Cell & cell) const
+  {
+#ifdef ASTAR_PATH_PLANNER_COUNT_COLLISION_CHECKS
+    ++check_count_;
+#endif
+    return collision_[cell] != 0;
+  }
+
+#ifdef ASTAR_PATH_PLANNER_COUNT_COLLISION_CHECKS
+  // Number of collision checks made so far. Only compiled into the benchmark, and not safe to use
+  // while several threads search the same map.
+  std::size_t GetCheckCount() const
+  {
+    return check_count_;
+  }
+#endif
+
+private:
+  std::vector<std::uint8_t> collision_;
+#ifdef ASTAR_PATH_PLANNER_COUNT_COLLISION_CHECKS
+  mutable std::size_t check_count_ = 0;
+#endif
+};
+
+}  // namespace astar_path_planner
+
+#endif  // COLLISION_MAP_HPP_
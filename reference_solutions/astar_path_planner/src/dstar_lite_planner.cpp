@@ -0,0 +1,289 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "dstar_lite_planner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace astar_path_planner
+{
+
+namespace
+{
+constexpr auto kInfinity = std::numeric_limits<double>::infinity();
+// Keys of cells on the same shortest path can differ by rounding error alone
+constexpr auto kKeyTolerance = 1e-9;
+}  // namespace
+
+DStarLitePlanner::DStarLitePlanner(rclcpp_lifecycle::LifecycleNode::SharedPtr node)
+: DStarLitePlanner(node->get_logger())
+{
+}
+
+DStarLitePlanner::DStarLitePlanner(const rclcpp::Logger & logger)
+: logger_(logger)
+{
+}
+
+std::vector<Point> DStarLitePlanner::Plan(
+  std::shared_ptr<const PlanningContext> context, const Point & start,
+  const Point & goal)
+{
+  const auto & grid = context->GetGrid();
+  const auto & collision_map = context->GetCollisionMap();
+
+  Cell start_cell;
+  if (!grid.PointToCell(start, start_cell)) {
+    RCLCPP_ERROR(
+      logger_, "Starting position (%f, %f) is outside of the costmap",
+      start.x(), start.y());
+    return {};
+  }
+
+  Cell goal_cell;
+  if (!grid.PointToCell(goal, goal_cell)) {
+    RCLCPP_ERROR(logger_, "Provided goal position is outside of the costmap");
+    return {};
+  }
+
+  if (collision_map.IsCellInCollision(goal_cell)) {
+    RCLCPP_ERROR(logger_, "Provided goal position would cause a collision");
+    return {};
+  }
+
+  if (collision_map.IsCellInCollision(start_cell)) {
+    RCLCPP_ERROR(
+      logger_, "Starting position (%f, %f) is currently in a collision",
+      start.x(), start.y());
+    return {};
+  }
+
+  if (!context_ || goal_cell != goal_cell_ || !context_->GetGrid().HasSameLayout(grid)) {
+    Reset(context, start_cell, goal_cell);
+  } else {
+    // Robot motion only shifts the heuristic, which is folded into every key through km
+    start_cell_ = start_cell;
+    key_modifier_ += GetHeuristicCost(last_start_cell_, start_cell_);
+    last_start_cell_ = start_cell_;
+    if (context != context_) {
+      ApplyContextChange(context);
+    }
+  }
+
+  expanded_.assign(grid.GetCellCount(), false);
+
+  ComputeShortestPath();
+
+  // The search may stop with the start overconsistent, so its rhs holds the true cost
+  if (std::isinf(rhs_[start_cell_])) {
+    RCLCPP_ERROR(logger_, "No path found after exhausting search space.");
+    return {};
+  }
+
+  return ExtractPath(start, goal);
+}
+
+void DStarLitePlanner::Reset(
+  std::shared_ptr<const PlanningContext> context, const Cell & start,
+  const Cell & goal)
+{
+  context_ = context;
+  start_cell_ = start;
+  last_start_cell_ = start;
+  goal_cell_ = goal;
+  key_modifier_ = 0.0;
+
+  const auto cell_count = context_->GetGrid().GetCellCount();
+  g_.assign(cell_count, kInfinity);
+  rhs_.assign(cell_count, kInfinity);
+  open_keys_.resize(cell_count);
+  in_open_.assign(cell_count, false);
+  open_ = OpenQueue{};
+
+  rhs_[goal_cell_] = 0.0;
+  UpdateQueue(goal_cell_);
+}
+
+void DStarLitePlanner::ApplyContextChange(std::shared_ptr<const PlanningContext> context)
+{
+  const auto previous_context = context_;
+  context_ = context;
+
+  const auto & old_collisions = previous_context->GetCollisionMap();
+  const auto & new_collisions = context_->GetCollisionMap();
+  const auto cell_count = context_->GetGrid().GetCellCount();
+  for (Cell cell = 0; cell < cell_count; ++cell) {
+    if (old_collisions.IsCellInCollision(cell) == new_collisions.IsCellInCollision(cell)) {
+      continue;
+    }
+    // Every edge touching this cell changed cost
+    UpdateVertex(cell);
+    ForEachNeighbor(
+      cell, [this](const Cell & neighbor, const GridMove &) {
+        UpdateVertex(neighbor);
+      });
+  }
+}
+
+void DStarLitePlanner::ComputeShortestPath()
+{
+  while (true) {
+    while (!open_.empty() &&
+      (!in_open_[open_.top().cell] || open_keys_[open_.top().cell] != open_.top().key))
+    {
+      open_.pop();
+    }
+
+    if (open_.empty()) {
+      return;
+    }
+
+    // Stop once the start is not underconsistent and every queued key is definitely larger than
+    // the start's. Primary key ties are still expanded so rounding can't leave a stale cell on
+    // the path.
+    const auto entry = open_.top();
+    const auto top_is_larger =
+      entry.key.primary > CalculateKey(start_cell_).primary + kKeyTolerance;
+    if (top_is_larger && rhs_[start_cell_] <= g_[start_cell_]) {
+      return;
+    }
+
+    const auto cell = entry.cell;
+    const auto new_key = CalculateKey(cell);
+    expanded_[cell] = true;
+
+    if (entry.key < new_key) {
+      // Key is out of date because the start moved since this cell was queued
+      UpdateQueue(cell);
+    } else if (g_[cell] > rhs_[cell]) {
+      // Overconsistent, so the cheaper cost can be propagated to predecessors directly
+      g_[cell] = rhs_[cell];
+      in_open_[cell] = false;
+      ForEachNeighbor(
+        cell, [this, &cell](const Cell & neighbor, const GridMove & move) {
+          if (neighbor != goal_cell_ && !IsBlocked(neighbor)) {
+            rhs_[neighbor] = std::min(rhs_[neighbor], move.distance + g_[cell]);
+          }
+          UpdateQueue(neighbor);
+        });
+    } else {
+      // Underconsistent, so every predecessor has to recompute its best successor
+      g_[cell] = kInfinity;
+      UpdateVertex(cell);
+      ForEachNeighbor(
+        cell, [this](const Cell & neighbor, const GridMove &) {
+          UpdateVertex(neighbor);
+        });
+    }
+  }
+}
+
+std::vector<Point> DStarLitePlanner::ExtractPath(const Point & start, const Point & goal)
+{
+  const auto & grid = context_->GetGrid();
+  std::vector<Point> path{start};
+  auto cell = start_cell_;
+  // Following the gradient of g can't revisit a cell, so the path can be no longer than the grid
+  for (std::size_t step = 0; cell != goal_cell_ && step < grid.GetCellCount(); ++step) {
+    auto best_cost = kInfinity;
+    auto best_cell = cell;
+    ForEachNeighbor(
+      cell, [this, &best_cost, &best_cell](const Cell & neighbor, const GridMove & move) {
+        if (IsBlocked(neighbor)) {
+          return;
+        }
+        const auto cost = move.distance + g_[neighbor];
+        if (cost < best_cost) {
+          best_cost = cost;
+          best_cell = neighbor;
+        }
+      });
+    if (std::isinf(best_cost)) {
+      RCLCPP_ERROR(logger_, "Incremental search left no path to follow from the start.");
+      return {};
+    }
+    cell = best_cell;
+    path.push_back(grid.CellToPoint(cell));
+  }
+  if (cell != goal_cell_) {
+    RCLCPP_ERROR(logger_, "Incremental search produced a cyclic path.");
+    return {};
+  }
+  if (path.size() > 1) {
+    path.back() = goal;
+  }
+  return path;
+}
+
+DStarLitePlanner::Key DStarLitePlanner::CalculateKey(const Cell & cell) const
+{
+  const auto cost = std::min(g_[cell], rhs_[cell]);
+  return {cost + GetHeuristicCost(start_cell_, cell) + key_modifier_, cost};
+}
+
+double DStarLitePlanner::GetHeuristicCost(const Cell & from, const Cell & to) const
+{
+  const auto & grid = context_->GetGrid();
+  const auto dx = grid.GetX(from) - grid.GetX(to);
+  const auto dy = grid.GetY(from) - grid.GetY(to);
+  return grid.GetGridSize() * std::hypot(dx, dy);
+}
+
+bool DStarLitePlanner::IsBlocked(const Cell & cell) const
+{
+  return context_->GetCollisionMap().IsCellInCollision(cell);
+}
+
+void DStarLitePlanner::UpdateVertex(const Cell & cell)
+{
+  if (cell != goal_cell_) {
+    auto rhs = kInfinity;
+    if (!IsBlocked(cell)) {
+      ForEachNeighbor(
+        cell, [this, &rhs](const Cell & neighbor, const GridMove & move) {
+          if (!IsBlocked(neighbor)) {
+            rhs = std::min(rhs, move.distance + g_[neighbor]);
+          }
+        });
+    }
+    rhs_[cell] = rhs;
+  }
+  UpdateQueue(cell);
+}
+
+void DStarLitePlanner::UpdateQueue(const Cell & cell)
+{
+  if (g_[cell] == rhs_[cell]) {
+    in_open_[cell] = false;
+    return;
+  }
+  const auto key = CalculateKey(cell);
+  if (in_open_[cell] && !(open_keys_[cell] != key)) {
+    return;
+  }
+  in_open_[cell] = true;
+  open_keys_[cell] = key;
+  open_.push({key, cell});
+}
+
+}  // namespace astar_path_planner
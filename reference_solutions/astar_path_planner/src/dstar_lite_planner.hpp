@@ -0,0 +1,145 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef DSTAR_LITE_PLANNER_HPP_
+#define DSTAR_LITE_PLANNER_HPP_
+
+#include <memory>
+#include <queue>
+#include <vector>
+#include <rclcpp_lifecycle/lifecycle_node.hpp>
+#include "planning_context.hpp"
+#include "search_grid.hpp"
+#include "utils.hpp"
+
+namespace astar_path_planner
+{
+
+// Incremental planner based on D* Lite (Koenig & Likhachev, 2002).
+// The search runs backwards from the goal and its state is kept between calls to Plan. As long as
+// the goal cell and grid layout stay the same, later calls only repair the part of the search
+// affected by the robot's motion and by cells whose collision state changed.
+// Only the search is incremental. A costmap change still means building a new context, with a full
+// distance transform, and comparing every cell's collision state, so map updates cost O(cells)
+// before any repair. Moving the start on an unchanged map is the cheap case.
+class DStarLitePlanner
+{
+public:
+  using ExpandedSet = std::vector<bool>;
+
+  explicit DStarLitePlanner(rclcpp_lifecycle::LifecycleNode::SharedPtr node);
+
+  explicit DStarLitePlanner(
+    const rclcpp::Logger & logger = rclcpp::get_logger("astar_path_planner"));
+
+  std::vector<Point> Plan(
+    std::shared_ptr<const PlanningContext> context, const Point & start,
+    const Point & goal);
+
+  // Cells expanded during the most recent call to Plan
+  const ExpandedSet & GetExpandedSet() const
+  {
+    return expanded_;
+  }
+
+private:
+  struct Key
+  {
+    double primary;
+    double secondary;
+
+    bool operator<(const Key & other) const
+    {
+      return primary < other.primary ||
+             (primary == other.primary && secondary < other.secondary);
+    }
+
+    bool operator!=(const Key & other) const
+    {
+      return primary != other.primary || secondary != other.secondary;
+    }
+  };
+
+  struct OpenEntry
+  {
+    Key key;
+    Cell cell;
+  };
+
+  struct OpenEntryComparator
+  {
+    bool operator()(const OpenEntry & a, const OpenEntry & b) const
+    {
+      return b.key < a.key;
+    }
+  };
+
+  // Entries are never removed from the heap directly. An entry is live only while its cell is
+  // marked open and its key matches the cell's current key.
+  using OpenQueue = std::priority_queue<OpenEntry, std::vector<OpenEntry>, OpenEntryComparator>;
+
+  rclcpp::Logger logger_;
+  std::shared_ptr<const PlanningContext> context_;
+  Cell start_cell_ = 0;
+  Cell last_start_cell_ = 0;
+  Cell goal_cell_ = 0;
+  double key_modifier_ = 0.0;
+  std::vector<double> g_;
+  std::vector<double> rhs_;
+  std::vector<Key> open_keys_;
+  std::vector<bool> in_open_;
+  OpenQueue open_;
+  ExpandedSet expanded_;
+
+  void Reset(std::shared_ptr<const PlanningContext> context, const Cell & start, const Cell & goal);
+
+  void ApplyContextChange(std::shared_ptr<const PlanningContext> context);
+
+  void ComputeShortestPath();
+
+  std::vector<Point> ExtractPath(const Point & start, const Point & goal);
+
+  Key CalculateKey(const Cell & cell) const;
+
+  double GetHeuristicCost(const Cell & from, const Cell & to) const;
+
+  bool IsBlocked(const Cell & cell) const;
+
+  void UpdateVertex(const Cell & cell);
+
+  void UpdateQueue(const Cell & cell);
+
+  template<typename Callback>
+  void ForEachNeighbor(const Cell & cell, Callback callback) const
+  {
+    const auto & grid = context_->GetGrid();
+    const auto x = grid.GetX(cell);
+    const auto y = grid.GetY(cell);
+    for (const auto & move : context_->GetMoves()) {
+      if (grid.IsInBounds(x + move.dx, y + move.dy)) {
+        callback(cell + move.offset, move);
+      }
+    }
+  }
+};
+
+}  // namespace astar_path_planner
+
+#endif  // DSTAR_LITE_PLANNER_HPP_
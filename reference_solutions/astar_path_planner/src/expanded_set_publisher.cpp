@@ -0,0 +1,135 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "expanded_set_publisher.hpp"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace astar_path_planner
+{
+
+ExpandedSetPublisher::ExpandedSetPublisher(
+  Publisher::SharedPtr publisher,
+  const std::string & frame_id, const double & max_rate)
+: publisher_(publisher),
+  frame_id_(frame_id),
+  min_period_(
+    max_rate > 0.0 ?
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(1.0 / max_rate)) :
+    std::chrono::steady_clock::duration::zero()),
+  thread_(&ExpandedSetPublisher::PublishLoop, this)
+{
+}
+
+ExpandedSetPublisher::~ExpandedSetPublisher()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_one();
+  thread_.join();
+}
+
+void ExpandedSetPublisher::Publish(
+  const std::vector<bool> & expanded, const SearchGrid & grid,
+  const builtin_interfaces::msg::Time & stamp, const int decimation)
+{
+  if (publisher_->get_subscription_count() == 0 || expanded.size() != grid.GetCellCount()) {
+    return;
+  }
+  // Reuse the storage of a set that was already published or replaced, so copying the bit-packed
+  // set needs no allocation once the grid size settles
+  std::vector<bool> buffer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer = pending_.has_value() ? std::move(pending_->expanded) : std::move(spare_);
+    pending_.reset();
+  }
+  buffer = expanded;
+  Snapshot snapshot{std::move(buffer), grid, stamp, std::max(decimation, 1)};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_ = std::move(snapshot);
+  }
+  wake_.notify_one();
+}
+
+void ExpandedSetPublisher::PublishLoop()
+{
+  auto next_publish_time = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_.wait(lock, [this] {return stopping_ || pending_.has_value();});
+    // Newer sets replace the pending one while waiting out the rate limit
+    wake_.wait_until(lock, next_publish_time, [this] {return stopping_;});
+    if (stopping_) {
+      return;
+    }
+    auto snapshot = std::move(*pending_);
+    pending_.reset();
+    lock.unlock();
+
+    publisher_->publish(MakeMessage(snapshot));
+    next_publish_time = std::chrono::steady_clock::now() + min_period_;
+
+    lock.lock();
+    spare_ = std::move(snapshot.expanded);
+  }
+}
+
+nav_msgs::msg::OccupancyGrid ExpandedSetPublisher::MakeMessage(const Snapshot & snapshot) const
+{
+  const auto & grid = snapshot.grid;
+  const auto decimation = snapshot.decimation;
+  const auto width = (grid.GetSizeX() + decimation - 1) / decimation;
+  const auto height = (grid.GetSizeY() + decimation - 1) / decimation;
+
+  nav_msgs::msg::OccupancyGrid message;
+  message.header.frame_id = frame_id_;
+  message.header.stamp = snapshot.stamp;
+  message.info.resolution = grid.GetGridSize() * decimation;
+  message.info.width = width;
+  message.info.height = height;
+  // Corner of the first cell, which is half a cell from its center
+  const auto origin = grid.CellToPoint(0);
+  message.info.origin.position.x = origin.x() - 0.5 * grid.GetGridSize();
+  message.info.origin.position.y = origin.y() - 0.5 * grid.GetGridSize();
+  message.info.origin.orientation.w = 1.0;
+  message.data.assign(static_cast<std::size_t>(width) * height, 0);
+
+  for (int y = 0; y < grid.GetSizeY(); ++y) {
+    auto * row = message.data.data() + static_cast<std::size_t>(y / decimation) * width;
+    const auto first_cell = grid.GetCell(0, y);
+    for (int x = 0; x < grid.GetSizeX(); ++x) {
+      if (snapshot.expanded[first_cell + x]) {
+        row[x / decimation] = 100;
+      }
+    }
+  }
+  return message;
+}
+
+}  // namespace astar_path_planner
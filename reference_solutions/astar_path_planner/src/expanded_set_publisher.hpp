@@ -0,0 +1,91 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef EXPANDED_SET_PUBLISHER_HPP_
+#define EXPANDED_SET_PUBLISHER_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <builtin_interfaces/msg/time.hpp>
+#include <nav_msgs/msg/occupancy_grid.hpp>
+#include <rclcpp_lifecycle/lifecycle_publisher.hpp>
+#include "search_grid.hpp"
+
+namespace astar_path_planner
+{
+
+// Publishes expanded sets as occupancy grids from a background thread, so planning never waits on
+// message construction. Only the newest set waiting to be published is kept, and publishing is
+// limited to a maximum rate.
+class ExpandedSetPublisher
+{
+public:
+  using Publisher = rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::OccupancyGrid>;
+
+  // A max_rate of 0 publishes every set the background thread gets to
+  ExpandedSetPublisher(
+    Publisher::SharedPtr publisher, const std::string & frame_id,
+    const double & max_rate);
+
+  ~ExpandedSetPublisher();
+
+  ExpandedSetPublisher(const ExpandedSetPublisher &) = delete;
+  ExpandedSetPublisher & operator=(const ExpandedSetPublisher &) = delete;
+
+  // Queues a copy of the expanded set if anyone is subscribed. Each published grid cell covers
+  // decimation x decimation search cells and is occupied if any of them was expanded.
+  void Publish(
+    const std::vector<bool> & expanded, const SearchGrid & grid,
+    const builtin_interfaces::msg::Time & stamp, const int decimation);
+
+private:
+  struct Snapshot
+  {
+    std::vector<bool> expanded;
+    SearchGrid grid;
+    builtin_interfaces::msg::Time stamp;
+    int decimation;
+  };
+
+  Publisher::SharedPtr publisher_;
+  std::string frame_id_;
+  std::chrono::steady_clock::duration min_period_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::optional<Snapshot> pending_;
+  // Storage of the last published set, handed back to Publish to copy the next set into
+  std::vector<bool> spare_;
+  bool stopping_ = false;
+  // Started last so every other member is ready when it runs
+  std::thread thread_;
+
+  void PublishLoop();
+
+  nav_msgs::msg::OccupancyGrid MakeMessage(const Snapshot & snapshot) const;
+};
+
+}  // namespace astar_path_planner
+
+#endif  // EXPANDED_SET_PUBLISHER_HPP_
@@ -0,0 +1,351 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "hierarchical_search.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace astar_path_planner
+{
+
+HierarchicalSearch::HierarchicalSearch(
+  const PlanningContext & context, const CostScaleTable & cost_scale,
+  const int block_size)
+: context_(context),
+  cost_scale_(cost_scale),
+  // Labels are 16 bit, which is enough for every region of a block up to 256 cells wide
+  block_size_(std::clamp(block_size, 1, 256))
+{
+  const auto & grid = context_.GetGrid();
+  blocks_x_ = (grid.GetSizeX() + block_size_ - 1) / block_size_;
+  blocks_y_ = (grid.GetSizeY() + block_size_ - 1) / block_size_;
+  block_labels_.resize(static_cast<std::size_t>(blocks_x_) * blocks_y_);
+  block_first_node_.resize(block_labels_.size());
+}
+
+std::vector<Cell> HierarchicalSearch::Search(
+  const Cell & start, const Cell & goal,
+  std::vector<bool> & expanded)
+{
+  expanded.assign(context_.GetGrid().GetCellCount(), false);
+
+  const auto route = FindBlockRoute(start, goal);
+  if (route.empty()) {
+    return {};
+  }
+
+  // Mark every block within the corridor radius of the route and give it a slot in the
+  // compact per-cell arrays used by the full resolution search
+  block_slots_.assign(block_labels_.size(), -1);
+  int slot_count = 0;
+  for (const auto & block : route) {
+    const auto bx = static_cast<int>(block % blocks_x_);
+    const auto by = static_cast<int>(block / blocks_x_);
+    for (int y = std::max(by - kCorridorRadius, 0);
+      y <= std::min(by + kCorridorRadius, blocks_y_ - 1); ++y)
+    {
+      for (int x = std::max(bx - kCorridorRadius, 0);
+        x <= std::min(bx + kCorridorRadius, blocks_x_ - 1); ++x)
+      {
+        auto & slot = block_slots_[static_cast<std::size_t>(y) * blocks_x_ + x];
+        if (slot < 0) {
+          slot = slot_count++;
+        }
+      }
+    }
+  }
+
+  return SearchCorridor(start, goal, slot_count, expanded);
+}
+
+std::vector<std::size_t> HierarchicalSearch::FindBlockRoute(const Cell & start, const Cell & goal)
+{
+  const auto & grid = context_.GetGrid();
+  const auto block_length = block_size_ * grid.GetGridSize();
+  const auto start_node = GetNode(grid.GetX(start), grid.GetY(start));
+  const auto goal_node = GetNode(grid.GetX(goal), grid.GetY(goal));
+  const auto goal_bx = static_cast<int>(node_blocks_[goal_node] % blocks_x_);
+  const auto goal_by = static_cast<int>(node_blocks_[goal_node] / blocks_x_);
+  auto block_distance = [&](const std::size_t & block, const int bx, const int by) {
+      const auto dx = static_cast<int>(block % blocks_x_) - bx;
+      const auto dy = static_cast<int>(block / blocks_x_) - by;
+      return block_length * std::hypot(dx, dy);
+    };
+
+  // Nodes are created as blocks get labeled, so the per-node arrays grow with the search
+  std::vector<double> path_costs;
+  std::vector<std::size_t> parents;
+  std::vector<bool> expanded;
+  auto grow = [&]() {
+      path_costs.resize(node_blocks_.size(), std::numeric_limits<double>::infinity());
+      parents.resize(node_blocks_.size());
+      expanded.resize(node_blocks_.size(), false);
+    };
+  grow();
+
+  FrontierQueue frontier;
+  path_costs[start_node] = 0.0;
+  parents[start_node] = start_node;
+  frontier.push({start_node, block_distance(node_blocks_[start_node], goal_bx, goal_by), 0.0});
+
+  std::vector<std::size_t> neighbors;
+  while (!frontier.empty()) {
+    const auto entry = frontier.top();
+    frontier.pop();
+    if (expanded[entry.cell]) {
+      continue;
+    }
+    expanded[entry.cell] = true;
+
+    if (entry.cell == goal_node) {
+      std::vector<std::size_t> route{node_blocks_[goal_node]};
+      auto node = goal_node;
+      while (parents[node] != node) {
+        node = parents[node];
+        route.push_back(node_blocks_[node]);
+      }
+      return route;
+    }
+
+    neighbors.clear();
+    GetNeighborNodes(entry.cell, neighbors);
+    grow();
+    const auto block = node_blocks_[entry.cell];
+    const auto bx = static_cast<int>(block % blocks_x_);
+    const auto by = static_cast<int>(block / blocks_x_);
+    for (const auto & next : neighbors) {
+      if (expanded[next]) {
+        continue;
+      }
+      const auto new_path_cost = entry.path_cost + block_distance(node_blocks_[next], bx, by);
+      if (new_path_cost >= path_costs[next]) {
+        continue;
+      }
+      path_costs[next] = new_path_cost;
+      parents[next] = entry.cell;
+      frontier.push(
+        {next, new_path_cost + block_distance(node_blocks_[next], goal_bx, goal_by),
+          new_path_cost});
+    }
+  }
+
+  return {};
+}
+
+std::vector<Cell> HierarchicalSearch::SearchCorridor(
+  const Cell & start, const Cell & goal, const int slot_count,
+  std::vector<bool> & expanded)
+{
+  const auto & grid = context_.GetGrid();
+  const auto & collision_map = context_.GetCollisionMap();
+  const auto block_cells = static_cast<std::size_t>(block_size_) * block_size_;
+
+  // Per-cell state is indexed by corridor slot so memory scales with the corridor, not the map
+  auto local_index = [&](const int x, const int y) -> std::size_t {
+      const auto slot = block_slots_[GetBlock(x, y)];
+      if (slot < 0) {
+        return std::numeric_limits<std::size_t>::max();
+      }
+      return static_cast<std::size_t>(slot) * block_cells +
+             static_cast<std::size_t>(y % block_size_) * block_size_ + x % block_size_;
+    };
+
+  const auto local_count = static_cast<std::size_t>(slot_count) * block_cells;
+  std::vector<double> path_costs(local_count, std::numeric_limits<double>::infinity());
+  std::vector<Cell> parents(local_count);
+  std::vector<bool> closed(local_count, false);
+
+  const auto goal_x = grid.GetX(goal);
+  const auto goal_y = grid.GetY(goal);
+  auto heuristic = [&](const int x, const int y) {
+      return grid.GetGridSize() * std::hypot(x - goal_x, y - goal_y);
+    };
+
+  FrontierQueue frontier;
+  const auto start_index = local_index(grid.GetX(start), grid.GetY(start));
+  path_costs[start_index] = 0.0;
+  parents[start_index] = start;
+  frontier.push({start, heuristic(grid.GetX(start), grid.GetY(start)), 0.0});
+
+  while (!frontier.empty()) {
+    const auto entry = frontier.top();
+    frontier.pop();
+
+    const auto x = grid.GetX(entry.cell);
+    const auto y = grid.GetY(entry.cell);
+    const auto index = local_index(x, y);
+    if (closed[index]) {
+      continue;
+    }
+    closed[index] = true;
+    expanded[entry.cell] = true;
+
+    if (entry.cell == goal) {
+      std::vector<Cell> path{goal};
+      auto cell = goal;
+      auto cell_index = index;
+      while (parents[cell_index] != cell) {
+        cell = parents[cell_index];
+        cell_index = local_index(grid.GetX(cell), grid.GetY(cell));
+        path.push_back(cell);
+      }
+      std::reverse(path.begin(), path.end());
+      return path;
+    }
+
+    for (const auto & move : context_.GetMoves()) {
+      const auto next_x = x + move.dx;
+      const auto next_y = y + move.dy;
+      if (!grid.IsInBounds(next_x, next_y)) {
+        continue;
+      }
+      const auto next_index = local_index(next_x, next_y);
+      if (next_index == std::numeric_limits<std::size_t>::max() || closed[next_index]) {
+        continue;
+      }
+      const Cell next_cell = entry.cell + move.offset;
+      if (collision_map.IsCellInCollision(next_cell)) {
+        continue;
+      }
+      const auto new_path_cost =
+        entry.path_cost + move.distance * cost_scale_[context_.GetCellCost(next_cell)];
+      if (new_path_cost >= path_costs[next_index]) {
+        continue;
+      }
+      path_costs[next_index] = new_path_cost;
+      parents[next_index] = entry.cell;
+      frontier.push({next_cell, new_path_cost + heuristic(next_x, next_y), new_path_cost});
+    }
+  }
+
+  return {};
+}
+
+void HierarchicalSearch::GetNeighborNodes(
+  const std::size_t & node,
+  std::vector<std::size_t> & neighbors)
+{
+  const auto & grid = context_.GetGrid();
+  const auto block = node_blocks_[node];
+  const auto label = static_cast<Label>(node - block_first_node_[block] + 1);
+  const auto x_begin = static_cast<int>(block % blocks_x_) * block_size_;
+  const auto y_begin = static_cast<int>(block / blocks_x_) * block_size_;
+  const auto x_end = std::min(x_begin + block_size_, grid.GetSizeX());
+  const auto y_end = std::min(y_begin + block_size_, grid.GetSizeY());
+
+  for (int y = y_begin; y < y_end; ++y) {
+    // Only cells on the block's border can step into another block
+    const auto on_edge_row = y == y_begin || y == y_end - 1;
+    for (int x = x_begin; x < x_end; x += on_edge_row ? 1 : std::max(x_end - x_begin - 1, 1)) {
+      if (block_labels_[block][(y - y_begin) * block_size_ + (x - x_begin)] != label) {
+        continue;
+      }
+      for (const auto & move : context_.GetMoves()) {
+        const auto next_x = x + move.dx;
+        const auto next_y = y + move.dy;
+        if (!grid.IsInBounds(next_x, next_y) || GetBlock(next_x, next_y) == block ||
+          GetLabel(next_x, next_y) == 0)
+        {
+          continue;
+        }
+        const auto next = GetNode(next_x, next_y);
+        if (std::find(neighbors.begin(), neighbors.end(), next) == neighbors.end()) {
+          neighbors.push_back(next);
+        }
+      }
+    }
+  }
+}
+
+std::size_t HierarchicalSearch::GetNode(const int x, const int y)
+{
+  const auto label = GetLabel(x, y);
+  return block_first_node_[GetBlock(x, y)] + label - 1;
+}
+
+HierarchicalSearch::Label HierarchicalSearch::GetLabel(const int x, const int y)
+{
+  const auto block = GetBlock(x, y);
+  if (block_labels_[block].empty()) {
+    LabelBlock(block);
+  }
+  const auto local_x = x % block_size_;
+  const auto local_y = y % block_size_;
+  return block_labels_[block][local_y * block_size_ + local_x];
+}
+
+void HierarchicalSearch::LabelBlock(const std::size_t & block)
+{
+  const auto & grid = context_.GetGrid();
+  const auto & collision_map = context_.GetCollisionMap();
+  const auto x_begin = static_cast<int>(block % blocks_x_) * block_size_;
+  const auto y_begin = static_cast<int>(block / blocks_x_) * block_size_;
+  const auto width = std::min(block_size_, grid.GetSizeX() - x_begin);
+  const auto height = std::min(block_size_, grid.GetSizeY() - y_begin);
+
+  // Cells start unlabeled if free and stay 0 if in collision
+  constexpr auto kUnlabeled = std::numeric_limits<Label>::max();
+  auto & labels = block_labels_[block];
+  labels.assign(static_cast<std::size_t>(block_size_) * block_size_, 0);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      if (!collision_map.IsCellInCollision(grid.GetCell(x_begin + x, y_begin + y))) {
+        labels[y * block_size_ + x] = kUnlabeled;
+      }
+    }
+  }
+
+  // Flood fill with the same 8-connected moves as the full resolution search
+  Label label_count = 0;
+  std::vector<int> stack;
+  for (int seed = 0; seed < block_size_ * block_size_; ++seed) {
+    if (labels[seed] != kUnlabeled) {
+      continue;
+    }
+    ++label_count;
+    labels[seed] = label_count;
+    stack.push_back(seed);
+    while (!stack.empty()) {
+      const auto index = stack.back();
+      stack.pop_back();
+      const auto x = index % block_size_;
+      const auto y = index / block_size_;
+      for (const auto & move : context_.GetMoves()) {
+        const auto next_x = x + move.dx;
+        const auto next_y = y + move.dy;
+        if (next_x < 0 || next_x >= width || next_y < 0 || next_y >= height) {
+          continue;
+        }
+        const auto next = next_y * block_size_ + next_x;
+        if (labels[next] == kUnlabeled) {
+          labels[next] = label_count;
+          stack.push_back(next);
+        }
+      }
+    }
+  }
+
+  block_first_node_[block] = node_blocks_.size();
+  node_blocks_.insert(node_blocks_.end(), label_count, block);
+}
+
+}  // namespace astar_path_planner
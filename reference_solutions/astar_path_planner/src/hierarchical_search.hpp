@@ -0,0 +1,102 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef HIERARCHICAL_SEARCH_HPP_
+#define HIERARCHICAL_SEARCH_HPP_
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+#include "planning_context.hpp"
+#include "search_grid.hpp"
+#include "utils.hpp"
+
+namespace astar_path_planner
+{
+
+// Two level search for large maps, in the style of HPA*. The search grid is divided into square
+// blocks and the free cells of each block are split into connected regions. A coarse A* over those
+// regions finds a route from the start to the goal, then a full resolution A* runs only inside a
+// corridor of blocks around that route, so its cost scales with the route length instead of the
+// map area. Regions are only labeled when the coarse search reaches their block.
+// Because regions are connected, a coarse route guarantees a path inside the corridor. That path
+// is optimal within the corridor but not necessarily over the whole map.
+class HierarchicalSearch
+{
+public:
+  HierarchicalSearch(
+    const PlanningContext & context, const CostScaleTable & cost_scale,
+    const int block_size);
+
+  // Returns the cells of a path from start to goal, or an empty vector if there is none.
+  // Cells expanded by the full resolution search are marked in `expanded`.
+  std::vector<Cell> Search(const Cell & start, const Cell & goal, std::vector<bool> & expanded);
+
+private:
+  using FrontierQueue = std::priority_queue<FrontierEntry, std::vector<FrontierEntry>,
+      FrontierEntryComparator>;
+  using Label = std::uint16_t;
+
+  // Number of blocks around the coarse route that are also searched at full resolution
+  static constexpr int kCorridorRadius = 1;
+
+  const PlanningContext & context_;
+  const CostScaleTable & cost_scale_;
+  int block_size_;
+  int blocks_x_;
+  int blocks_y_;
+  // Per block, the region label of each of its cells, with 0 for cells in collision. Empty until
+  // the block is first reached.
+  std::vector<std::vector<Label>> block_labels_;
+  // Per block, the coarse node of its first region. The others follow consecutively.
+  std::vector<std::size_t> block_first_node_;
+  // Per coarse node, the block it belongs to
+  std::vector<std::size_t> node_blocks_;
+  // Corridor slot of each block, or -1 for blocks outside the corridor
+  std::vector<int> block_slots_;
+
+  // Coarse A* over regions. Returns the blocks along the route, or empty if there is none.
+  std::vector<std::size_t> FindBlockRoute(const Cell & start, const Cell & goal);
+
+  // Full resolution A* restricted to blocks with a corridor slot
+  std::vector<Cell> SearchCorridor(
+    const Cell & start, const Cell & goal, const int slot_count,
+    std::vector<bool> & expanded);
+
+  // Appends the distinct coarse nodes reachable in one move from the region's border cells
+  void GetNeighborNodes(const std::size_t & node, std::vector<std::size_t> & neighbors);
+
+  // Returns the coarse node of the region containing a free cell
+  std::size_t GetNode(const int x, const int y);
+
+  // Region label of a cell, labeling its block first if needed
+  Label GetLabel(const int x, const int y);
+
+  void LabelBlock(const std::size_t & block);
+
+  std::size_t GetBlock(const int x, const int y) const
+  {
+    return static_cast<std::size_t>(y / block_size_) * blocks_x_ + x / block_size_;
+  }
+};
+
+}  // namespace astar_path_planner
+
+#endif  // HIERARCHICAL_SEARCH_HPP_
@@ -0,0 +1,228 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "jump_point_search.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace astar_path_planner
+{
+
+namespace
+{
+int Sign(const int value)
+{
+  return (value > 0) - (value < 0);
+}
+}  // namespace
+
+JumpPointSearch::JumpPointSearch(const PlanningContext & context)
+: context_(context)
+{
+}
+
+std::vector<Cell> JumpPointSearch::Search(
+  const Cell & start, const Cell & goal,
+  std::vector<bool> & expanded)
+{
+  const auto & grid = context_.GetGrid();
+  goal_ = goal;
+  path_costs_.assign(grid.GetCellCount(), std::numeric_limits<double>::infinity());
+  parents_.resize(grid.GetCellCount());
+  expanded.assign(grid.GetCellCount(), false);
+
+  FrontierQueue frontier;
+  path_costs_[start] = 0.0;
+  parents_[start] = start;
+  frontier.push({start, GetHeuristicCost(start), 0.0});
+
+  std::vector<std::pair<int, int>> directions;
+  directions.reserve(8);
+
+  while (!frontier.empty()) {
+    const auto entry = frontier.top();
+    frontier.pop();
+
+    if (expanded[entry.cell]) {
+      continue;
+    }
+    expanded[entry.cell] = true;
+
+    if (entry.cell == goal_) {
+      return ReconstructPath(entry.cell);
+    }
+
+    const auto x = grid.GetX(entry.cell);
+    const auto y = grid.GetY(entry.cell);
+
+    // Prune to the natural and forced neighbors given the direction we arrived from
+    directions.clear();
+    if (entry.cell == start) {
+      for (const auto & move : context_.GetMoves()) {
+        directions.emplace_back(move.dx, move.dy);
+      }
+    } else {
+      const auto parent = parents_[entry.cell];
+      const auto dx = Sign(x - grid.GetX(parent));
+      const auto dy = Sign(y - grid.GetY(parent));
+      if (dx != 0 && dy != 0) {
+        directions.emplace_back(dx, 0);
+        directions.emplace_back(0, dy);
+        directions.emplace_back(dx, dy);
+        if (!IsFree(x - dx, y)) {
+          directions.emplace_back(-dx, dy);
+        }
+        if (!IsFree(x, y - dy)) {
+          directions.emplace_back(dx, -dy);
+        }
+      } else if (dx != 0) {
+        directions.emplace_back(dx, 0);
+        if (!IsFree(x, y + 1)) {
+          directions.emplace_back(dx, 1);
+        }
+        if (!IsFree(x, y - 1)) {
+          directions.emplace_back(dx, -1);
+        }
+      } else {
+        directions.emplace_back(0, dy);
+        if (!IsFree(x + 1, y)) {
+          directions.emplace_back(1, dy);
+        }
+        if (!IsFree(x - 1, y)) {
+          directions.emplace_back(-1, dy);
+        }
+      }
+    }
+
+    for (const auto & [dx, dy] : directions) {
+      Cell jump_point;
+      if (!Jump(x, y, dx, dy, jump_point) || expanded[jump_point]) {
+        continue;
+      }
+      const auto new_path_cost = entry.path_cost + GetJumpCost(entry.cell, jump_point);
+      if (new_path_cost >= path_costs_[jump_point]) {
+        continue;
+      }
+      path_costs_[jump_point] = new_path_cost;
+      parents_[jump_point] = entry.cell;
+      frontier.push({jump_point, new_path_cost + GetHeuristicCost(jump_point), new_path_cost});
+    }
+  }
+
+  return {};
+}
+
+bool JumpPointSearch::Jump(int x, int y, const int dx, const int dy, Cell & jump_point) const
+{
+  const auto & grid = context_.GetGrid();
+  while (true) {
+    x += dx;
+    y += dy;
+    if (!IsFree(x, y)) {
+      return false;
+    }
+    const auto cell = grid.GetCell(x, y);
+    if (cell == goal_) {
+      jump_point = cell;
+      return true;
+    }
+    if (dx != 0 && dy != 0) {
+      // Diagonal moves stop where a forced neighbor appears or a straight scan finds a jump point
+      if ((IsFree(x - dx, y + dy) && !IsFree(x - dx, y)) ||
+        (IsFree(x + dx, y - dy) && !IsFree(x, y - dy)))
+      {
+        jump_point = cell;
+        return true;
+      }
+      Cell straight_jump_point;
+      if (Jump(x, y, dx, 0, straight_jump_point) || Jump(x, y, 0, dy, straight_jump_point)) {
+        jump_point = cell;
+        return true;
+      }
+    } else if (dx != 0) {
+      if ((IsFree(x + dx, y + 1) && !IsFree(x, y + 1)) ||
+        (IsFree(x + dx, y - 1) && !IsFree(x, y - 1)))
+      {
+        jump_point = cell;
+        return true;
+      }
+    } else {
+      if ((IsFree(x + 1, y + dy) && !IsFree(x + 1, y)) ||
+        (IsFree(x - 1, y + dy) && !IsFree(x - 1, y)))
+      {
+        jump_point = cell;
+        return true;
+      }
+    }
+  }
+}
+
+bool JumpPointSearch::IsFree(const int x, const int y) const
+{
+  const auto & grid = context_.GetGrid();
+  return grid.IsInBounds(x, y) &&
+         !context_.GetCollisionMap().IsCellInCollision(grid.GetCell(x, y));
+}
+
+double JumpPointSearch::GetJumpCost(const Cell & from, const Cell & to) const
+{
+  const auto & grid = context_.GetGrid();
+  const auto dx = std::abs(grid.GetX(to) - grid.GetX(from));
+  const auto dy = std::abs(grid.GetY(to) - grid.GetY(from));
+  const auto diagonal_steps = std::min(dx, dy);
+  const auto straight_steps = std::max(dx, dy) - diagonal_steps;
+  return grid.GetGridSize() * (std::sqrt(2.0) * diagonal_steps + straight_steps);
+}
+
+double JumpPointSearch::GetHeuristicCost(const Cell & cell) const
+{
+  const auto & grid = context_.GetGrid();
+  const auto dx = grid.GetX(cell) - grid.GetX(goal_);
+  const auto dy = grid.GetY(cell) - grid.GetY(goal_);
+  return grid.GetGridSize() * std::hypot(dx, dy);
+}
+
+std::vector<Cell> JumpPointSearch::ReconstructPath(Cell cell) const
+{
+  const auto & grid = context_.GetGrid();
+  std::vector<Cell> path{cell};
+  // Jump points are joined by straight or diagonal runs, so fill in every cell along each run
+  while (parents_[cell] != cell) {
+    const auto parent = parents_[cell];
+    const auto dx = Sign(grid.GetX(parent) - grid.GetX(cell));
+    const auto dy = Sign(grid.GetY(parent) - grid.GetY(cell));
+    auto x = grid.GetX(cell);
+    auto y = grid.GetY(cell);
+    while (grid.GetCell(x, y) != parent) {
+      x += dx;
+      y += dy;
+      path.push_back(grid.GetCell(x, y));
+    }
+    cell = parent;
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+}  // namespace astar_path_planner
@@ -0,0 +1,69 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef JUMP_POINT_SEARCH_HPP_
+#define JUMP_POINT_SEARCH_HPP_
+
+#include <queue>
+#include <vector>
+#include "planning_context.hpp"
+#include "search_grid.hpp"
+#include "utils.hpp"
+
+namespace astar_path_planner
+{
+
+// Jump Point Search (Harabor & Grastien, 2011) over the 8-connected search grid.
+// Uses the same moves, step costs and collision model as the A* search, so returned paths have
+// the same optimal cost, but symmetric paths through open space are pruned instead of expanded.
+class JumpPointSearch
+{
+public:
+  explicit JumpPointSearch(const PlanningContext & context);
+
+  // Returns the cells of an optimal path from start to goal, or an empty vector if there is none.
+  // Every jump point expanded during the search is marked in `expanded`.
+  std::vector<Cell> Search(const Cell & start, const Cell & goal, std::vector<bool> & expanded);
+
+private:
+  using FrontierQueue = std::priority_queue<FrontierEntry, std::vector<FrontierEntry>,
+      FrontierEntryComparator>;
+
+  const PlanningContext & context_;
+  Cell goal_;
+  std::vector<double> path_costs_;
+  std::vector<Cell> parents_;
+
+  // Scans from (x, y) in direction (dx, dy) and returns true with the first jump point found
+  bool Jump(int x, int y, const int dx, const int dy, Cell & jump_point) const;
+
+  bool IsFree(const int x, const int y) const;
+
+  // Octile distance between two cells, which is the exact step cost of a jump
+  double GetJumpCost(const Cell & from, const Cell & to) const;
+
+  double GetHeuristicCost(const Cell & cell) const;
+
+  std::vector<Cell> ReconstructPath(Cell cell) const;
+};
+
+}  // namespace astar_path_planner
+
+#endif  // JUMP_POINT_SEARCH_HPP_
@@ -0,0 +1,140 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "multi_goal_search.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace astar_path_planner
+{
+
+MultiGoalSearch::MultiGoalSearch(
+  const PlanningContext & context,
+  const CostScaleTable & cost_scale)
+: context_(context),
+  cost_scale_(cost_scale)
+{
+}
+
+void MultiGoalSearch::Search(
+  const Cell & start, const std::vector<Cell> & goals,
+  std::vector<bool> & expanded)
+{
+  const auto & grid = context_.GetGrid();
+  const auto & collision_map = context_.GetCollisionMap();
+  goals_ = goals;
+  path_costs_.assign(grid.GetCellCount(), std::numeric_limits<double>::infinity());
+  parents_.resize(grid.GetCellCount());
+  expanded.assign(grid.GetCellCount(), false);
+
+  // Goals are only counted once, in case several requested goals share a cell
+  std::sort(goals_.begin(), goals_.end());
+  goals_.erase(std::unique(goals_.begin(), goals_.end()), goals_.end());
+  if (goals_.empty()) {
+    return;
+  }
+
+  const FrontierEntryComparator comparator;
+  frontier_.clear();
+  path_costs_[start] = 0.0;
+  parents_[start] = start;
+  frontier_.push_back({start, GetHeuristicCost(start), 0.0});
+
+  while (!frontier_.empty()) {
+    std::pop_heap(frontier_.begin(), frontier_.end(), comparator);
+    const auto entry = frontier_.back();
+    frontier_.pop_back();
+
+    if (expanded[entry.cell]) {
+      continue;
+    }
+    expanded[entry.cell] = true;
+
+    const auto goal = std::lower_bound(goals_.begin(), goals_.end(), entry.cell);
+    if (goal != goals_.end() && *goal == entry.cell) {
+      goals_.erase(goal);
+      if (goals_.empty()) {
+        return;
+      }
+      // The heuristic now points at the remaining goals, so refresh every key in the frontier
+      frontier_.erase(
+        std::remove_if(
+          frontier_.begin(), frontier_.end(),
+          [&expanded](const FrontierEntry & queued) {return expanded[queued.cell];}),
+        frontier_.end());
+      for (auto & queued : frontier_) {
+        queued.cost = queued.path_cost + GetHeuristicCost(queued.cell);
+      }
+      std::make_heap(frontier_.begin(), frontier_.end(), comparator);
+    }
+
+    const auto x = grid.GetX(entry.cell);
+    const auto y = grid.GetY(entry.cell);
+    for (const auto & move : context_.GetMoves()) {
+      if (!grid.IsInBounds(x + move.dx, y + move.dy)) {
+        continue;
+      }
+      const Cell next_cell = entry.cell + move.offset;
+      if (expanded[next_cell] || collision_map.IsCellInCollision(next_cell)) {
+        continue;
+      }
+      const auto new_path_cost =
+        entry.path_cost + move.distance * cost_scale_[context_.GetCellCost(next_cell)];
+      if (new_path_cost >= path_costs_[next_cell]) {
+        continue;
+      }
+      path_costs_[next_cell] = new_path_cost;
+      parents_[next_cell] = entry.cell;
+      frontier_.push_back(
+        {next_cell, new_path_cost + GetHeuristicCost(next_cell), new_path_cost});
+      std::push_heap(frontier_.begin(), frontier_.end(), comparator);
+    }
+  }
+}
+
+std::vector<Cell> MultiGoalSearch::GetPath(Cell goal) const
+{
+  if (path_costs_[goal] == std::numeric_limits<double>::infinity()) {
+    return {};
+  }
+  std::vector<Cell> path{goal};
+  while (parents_[goal] != goal) {
+    goal = parents_[goal];
+    path.push_back(goal);
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+double MultiGoalSearch::GetHeuristicCost(const Cell & cell) const
+{
+  const auto & grid = context_.GetGrid();
+  const auto x = grid.GetX(cell);
+  const auto y = grid.GetY(cell);
+  auto nearest = std::numeric_limits<double>::infinity();
+  for (const auto & goal : goals_) {
+    nearest = std::min(nearest, std::hypot(grid.GetX(goal) - x, grid.GetY(goal) - y));
+  }
+  return grid.GetGridSize() * nearest;
+}
+
+}  // namespace astar_path_planner
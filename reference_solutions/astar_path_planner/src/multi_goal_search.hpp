@@ -0,0 +1,69 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef MULTI_GOAL_SEARCH_HPP_
+#define MULTI_GOAL_SEARCH_HPP_
+
+#include <vector>
+#include "planning_context.hpp"
+#include "search_grid.hpp"
+#include "utils.hpp"
+
+namespace astar_path_planner
+{
+
+// One-to-many search over the search grid. A single A* expansion from the start runs until every
+// goal has been expanded, guided by the distance to the nearest goal not yet reached. Whenever a
+// goal is reached the frontier is re-keyed for the remaining goals. Each of these heuristics is
+// consistent, so every expanded cell, including each goal, already has its optimal cost.
+class MultiGoalSearch
+{
+public:
+  MultiGoalSearch(const PlanningContext & context, const CostScaleTable & cost_scale);
+
+  // Searches from start until every reachable goal is expanded. Every expanded cell is marked in
+  // `expanded`.
+  void Search(const Cell & start, const std::vector<Cell> & goals, std::vector<bool> & expanded);
+
+  // Cost of the cheapest path to a goal passed to the last search, or infinity if it is unreachable
+  double GetPathCost(const Cell & goal) const
+  {
+    return path_costs_[goal];
+  }
+
+  // Cells of the cheapest path to a goal passed to the last search, or empty if it is unreachable
+  std::vector<Cell> GetPath(Cell goal) const;
+
+private:
+  const PlanningContext & context_;
+  const CostScaleTable & cost_scale_;
+  // Kept as a plain heap rather than a priority_queue so it can be re-keyed in place
+  std::vector<FrontierEntry> frontier_;
+  // Goals that have not been expanded yet
+  std::vector<Cell> goals_;
+  std::vector<double> path_costs_;
+  std::vector<Cell> parents_;
+
+  double GetHeuristicCost(const Cell & cell) const;
+};
+
+}  // namespace astar_path_planner
+
+#endif  // MULTI_GOAL_SEARCH_HPP_
@@ -0,0 +1,108 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "plan_cache.hpp"
+#include <functional>
+#include <vector>
+
+namespace astar_path_planner
+{
+
+std::size_t PlanCache::KeyHash::operator()(const Key & key) const
+{
+  std::size_t hash = std::hash<Cell>{}(key.goal_cell);
+  hash ^= std::hash<std::size_t>{}(key.revision) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  return hash;
+}
+
+PlanCache::PlanCache(const std::size_t & capacity)
+: capacity_(capacity)
+{
+}
+
+std::vector<Point> PlanCache::Lookup(
+  const PlanningContext & context, const std::size_t & revision,
+  const Point & start, const Point & goal, const double & rejoin_distance)
+{
+  const auto & grid = context.GetGrid();
+  Cell start_cell;
+  Cell goal_cell;
+  if (!grid.PointToCell(start, start_cell) || !grid.PointToCell(goal, goal_cell)) {
+    return {};
+  }
+  const auto found = index_.find({goal_cell, revision});
+  if (found == index_.end()) {
+    return {};
+  }
+  entries_.splice(entries_.begin(), entries_, found->second);
+  const auto & cached_path = found->second->second;
+
+  // Prefer the furthest waypoint so the joined path never doubles back along the cached one
+  for (auto i = cached_path.size(); i-- > 0; ) {
+    if ((cached_path[i] - start).norm() > rejoin_distance) {
+      continue;
+    }
+    Cell waypoint_cell;
+    if (!grid.PointToCell(cached_path[i], waypoint_cell) ||
+      !context.HasLineOfSight(start_cell, waypoint_cell))
+    {
+      continue;
+    }
+    // Skip the waypoint if the start is already in its cell
+    const auto rejoin = cached_path.begin() + i + (waypoint_cell == start_cell ? 1 : 0);
+    std::vector<Point> path{start};
+    path.insert(path.end(), rejoin, cached_path.end());
+    if (path.size() > 1) {
+      path.back() = goal;
+    }
+    return path;
+  }
+  return {};
+}
+
+void PlanCache::Insert(
+  const PlanningContext & context, const std::size_t & revision,
+  const std::vector<Point> & path)
+{
+  Cell goal_cell;
+  if (capacity_ == 0 || path.empty() || !context.GetGrid().PointToCell(path.back(), goal_cell)) {
+    return;
+  }
+  const Key key{goal_cell, revision};
+  const auto found = index_.find(key);
+  if (found != index_.end()) {
+    entries_.erase(found->second);
+    index_.erase(found);
+  }
+  entries_.emplace_front(key, path);
+  index_[key] = entries_.begin();
+  if (entries_.size() > capacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+}
+
+void PlanCache::Clear()
+{
+  entries_.clear();
+  index_.clear();
+}
+
+}  // namespace astar_path_planner
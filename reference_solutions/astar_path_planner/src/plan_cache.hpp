@@ -0,0 +1,84 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PLAN_CACHE_HPP_
+#define PLAN_CACHE_HPP_
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "planning_context.hpp"
+#include "search_grid.hpp"
+#include "utils.hpp"
+
+namespace astar_path_planner
+{
+
+// Least recently used cache of plans, keyed on goal cell and the revision of the planning context
+// they were made against. A cached plan is reused from a new start by joining it with a straight
+// segment, so repeated requests to the same goal skip the search while the costmap is unchanged.
+class PlanCache
+{
+public:
+  explicit PlanCache(const std::size_t & capacity);
+
+  // Returns a path from start to goal built from a cached plan to the goal's cell, or an empty
+  // path on a miss. The start is joined to the furthest waypoint within rejoin_distance of it that
+  // it has line of sight to.
+  std::vector<Point> Lookup(
+    const PlanningContext & context, const std::size_t & revision, const Point & start,
+    const Point & goal, const double & rejoin_distance);
+
+  void Insert(
+    const PlanningContext & context, const std::size_t & revision,
+    const std::vector<Point> & path);
+
+  void Clear();
+
+private:
+  struct Key
+  {
+    Cell goal_cell;
+    std::size_t revision;
+
+    bool operator==(const Key & other) const
+    {
+      return goal_cell == other.goal_cell && revision == other.revision;
+    }
+  };
+
+  struct KeyHash
+  {
+    std::size_t operator()(const Key & key) const;
+  };
+
+  using Entry = std::pair<Key, std::vector<Point>>;
+
+  std::size_t capacity_;
+  // Most recently used first
+  std::list<Entry> entries_;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+};
+
+}  // namespace astar_path_planner
+
+#endif  // PLAN_CACHE_HPP_
@@ -0,0 +1,135 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "planning_context.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+namespace astar_path_planner
+{
+
+PlanningContext::PlanningContext(
+  const nav2_costmap_2d::Costmap2D & costmap, const double & grid_size,
+  const double & collision_radius)
+: grid_size_(grid_size),
+  collision_radius_(collision_radius),
+  costmap_size_x_(costmap.getSizeInCellsX()),
+  costmap_size_y_(costmap.getSizeInCellsY()),
+  costmap_resolution_(costmap.getResolution()),
+  costmap_origin_x_(costmap.getOriginX()),
+  costmap_origin_y_(costmap.getOriginY()),
+  costmap_snapshot_(
+    costmap.getCharMap(), costmap.getCharMap() + (costmap_size_x_ * costmap_size_y_)),
+  grid_(costmap, grid_size),
+  collision_map_(costmap, grid_, collision_radius)
+{
+  // Grid cells share the costmap's origin, so each row and column maps to one costmap row and
+  // column that can be looked up once
+  const auto to_costmap_cell = [&](const int index, const unsigned int limit) {
+      const auto cell = static_cast<unsigned int>((index + 0.5) * grid_size / costmap_resolution_);
+      return std::min(cell, limit - 1);
+    };
+  std::vector<unsigned int> costmap_columns(grid_.GetSizeX());
+  for (int x = 0; x < grid_.GetSizeX(); ++x) {
+    costmap_columns[x] = to_costmap_cell(x, costmap_size_x_);
+  }
+  cell_costs_.resize(grid_.GetCellCount());
+  for (int y = 0; y < grid_.GetSizeY(); ++y) {
+    const auto * costmap_row = costmap_snapshot_.data() +
+      static_cast<std::size_t>(to_costmap_cell(y, costmap_size_y_)) * costmap_size_x_;
+    auto * row = cell_costs_.data() + grid_.GetCell(0, y);
+    for (int x = 0; x < grid_.GetSizeX(); ++x) {
+      row[x] = costmap_row[costmap_columns[x]];
+    }
+  }
+
+  const auto diagonal = std::sqrt(2.0) * grid_size;
+  const auto row = static_cast<std::ptrdiff_t>(grid_.GetSizeX());
+  moves_ = {{
+    {1, 0, 1, grid_size}, {-1, 0, -1, grid_size},
+    {0, 1, row, grid_size}, {0, -1, -row, grid_size},
+    {1, 1, row + 1, diagonal}, {1, -1, -row + 1, diagonal},
+    {-1, 1, row - 1, diagonal}, {-1, -1, -row - 1, diagonal}
+  }};
+}
+
+bool PlanningContext::IsValidFor(
+  const nav2_costmap_2d::Costmap2D & costmap, const double & grid_size,
+  const double & collision_radius) const
+{
+  if (grid_size != grid_size_ || collision_radius != collision_radius_) {
+    return false;
+  }
+  if (costmap.getSizeInCellsX() != costmap_size_x_ ||
+    costmap.getSizeInCellsY() != costmap_size_y_ ||
+    costmap.getResolution() != costmap_resolution_ ||
+    costmap.getOriginX() != costmap_origin_x_ ||
+    costmap.getOriginY() != costmap_origin_y_)
+  {
+    return false;
+  }
+  return std::equal(
+    costmap_snapshot_.begin(), costmap_snapshot_.end(), costmap.getCharMap());
+}
+
+bool PlanningContext::HasLineOfSight(const Cell & from, const Cell & to) const
+{
+  auto x = grid_.GetX(from);
+  auto y = grid_.GetY(from);
+  const auto x_end = grid_.GetX(to);
+  const auto y_end = grid_.GetY(to);
+  const auto dx = std::abs(x_end - x);
+  const auto dy = std::abs(y_end - y);
+  const auto x_step = x_end > x ? 1 : -1;
+  const auto y_step = y_end > y ? 1 : -1;
+
+  auto is_free = [this](const int cell_x, const int cell_y) {
+      return !collision_map_.IsCellInCollision(grid_.GetCell(cell_x, cell_y));
+    };
+
+  // Integer grid traversal visiting every cell the segment touches. When it passes exactly through
+  // a corner, both cells beside the corner are checked before stepping diagonally.
+  auto error = dx - dy;
+  for (auto remaining = dx + dy; remaining > 0; --remaining) {
+    if (!is_free(x, y)) {
+      return false;
+    }
+    if (error > 0) {
+      x += x_step;
+      error -= 2 * dy;
+    } else if (error < 0) {
+      y += y_step;
+      error += 2 * dx;
+    } else {
+      if (!is_free(x + x_step, y) || !is_free(x, y + y_step)) {
+        return false;
+      }
+      x += x_step;
+      y += y_step;
+      error += 2 * (dx - dy);
+      --remaining;
+    }
+  }
+  return is_free(x, y);
+}
+
+}  // namespace astar_path_planner
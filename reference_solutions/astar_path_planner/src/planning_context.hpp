@@ -0,0 +1,93 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PLANNING_CONTEXT_HPP_
+#define PLANNING_CONTEXT_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <nav2_costmap_2d/costmap_2d.hpp>
+#include "collision_map.hpp"
+#include "search_grid.hpp"
+#include "utils.hpp"
+
+namespace astar_path_planner
+{
+
+// Everything a search derives from the costmap. Contexts are immutable once built, so one can be
+// shared by every plan made against the same costmap contents and planner parameters.
+class PlanningContext
+{
+public:
+  using MoveTable = std::array<GridMove, 8>;
+
+  PlanningContext(
+    const nav2_costmap_2d::Costmap2D & costmap, const double & grid_size,
+    const double & collision_radius);
+
+  // True if this context was built from a costmap with identical geometry and contents, and with
+  // the same planner parameters.
+  bool IsValidFor(
+    const nav2_costmap_2d::Costmap2D & costmap, const double & grid_size,
+    const double & collision_radius) const;
+
+  // True if every grid cell crossed by the straight segment between the two cell centers is free
+  bool HasLineOfSight(const Cell & from, const Cell & to) const;
+
+  // Costmap cost under the center of a grid cell
+  std::uint8_t GetCellCost(const Cell & cell) const
+  {
+    return cell_costs_[cell];
+  }
+
+  const SearchGrid & GetGrid() const
+  {
+    return grid_;
+  }
+
+  const CollisionMap & GetCollisionMap() const
+  {
+    return collision_map_;
+  }
+
+  const MoveTable & GetMoves() const
+  {
+    return moves_;
+  }
+
+private:
+  double grid_size_;
+  double collision_radius_;
+  unsigned int costmap_size_x_;
+  unsigned int costmap_size_y_;
+  double costmap_resolution_;
+  double costmap_origin_x_;
+  double costmap_origin_y_;
+  std::vector<unsigned char> costmap_snapshot_;
+  SearchGrid grid_;
+  CollisionMap collision_map_;
+  std::vector<std::uint8_t> cell_costs_;
+  MoveTable moves_;
+};
+
+}  // namespace astar_path_planner
+
+#endif  // PLANNING_CONTEXT_HPP_
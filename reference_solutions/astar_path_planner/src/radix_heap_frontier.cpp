@@ -0,0 +1,91 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "radix_heap_frontier.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace astar_path_planner
+{
+
+void RadixHeapFrontier::push(const FrontierEntry & entry)
+{
+  buckets_[GetBucket(GetKey(entry.cost))].push_back(entry);
+  ++size_;
+}
+
+const FrontierEntry & RadixHeapFrontier::top()
+{
+  Refill();
+  return buckets_[0].back();
+}
+
+void RadixHeapFrontier::pop()
+{
+  Refill();
+  buckets_[0].pop_back();
+  --size_;
+}
+
+void RadixHeapFrontier::Refill()
+{
+  if (!buckets_[0].empty()) {
+    return;
+  }
+  auto bucket = std::find_if(
+    buckets_.begin() + 1, buckets_.end(),
+    [](const std::vector<FrontierEntry> & entries) {return !entries.empty();});
+  if (bucket == buckets_.end()) {
+    return;
+  }
+
+  auto entries = std::move(*bucket);
+  bucket->clear();
+  last_key_ = GetKey(
+    std::min_element(
+      entries.begin(), entries.end(),
+      [](const FrontierEntry & a, const FrontierEntry & b) {return a.cost < b.cost;})->cost);
+  // Every entry now differs from the new last key in a lower bit than before, so it lands in an
+  // earlier bucket, and the smallest ones in bucket 0
+  for (const auto & entry : entries) {
+    buckets_[GetBucket(GetKey(entry.cost))].push_back(entry);
+  }
+  // Hand the emptied storage back so the bucket keeps its capacity
+  entries.clear();
+  *bucket = std::move(entries);
+}
+
+std::uint64_t RadixHeapFrontier::GetKey(const double & cost)
+{
+  std::uint64_t key;
+  std::memcpy(&key, &cost, sizeof(key));
+  return key;
+}
+
+std::size_t RadixHeapFrontier::GetBucket(const std::uint64_t & key) const
+{
+  if (key <= last_key_) {
+    return 0;
+  }
+  return 64 - __builtin_clzll(key ^ last_key_);
+}
+
+}  // namespace astar_path_planner
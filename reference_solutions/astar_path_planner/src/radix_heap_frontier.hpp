@@ -0,0 +1,76 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef RADIX_HEAP_FRONTIER_HPP_
+#define RADIX_HEAP_FRONTIER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "utils.hpp"
+
+namespace astar_path_planner
+{
+
+// Monotone priority queue of frontier entries with the same interface as the planner's default
+// std::priority_queue. Entries are bucketed by the highest bit in which their key differs from the
+// last key popped, so pushes are O(1) and each entry moves down at most 64 buckets before it is
+// popped.
+//
+// Keys must not decrease below the last popped key, which A* guarantees with a consistent
+// heuristic. Entries that fall slightly below it through rounding are treated as equal to it.
+class RadixHeapFrontier
+{
+public:
+  bool empty() const
+  {
+    return size_ == 0;
+  }
+
+  std::size_t size() const
+  {
+    return size_;
+  }
+
+  void push(const FrontierEntry & entry);
+
+  // Entry with the smallest cost. Must not be called on an empty queue.
+  const FrontierEntry & top();
+
+  void pop();
+
+private:
+  std::array<std::vector<FrontierEntry>, 65> buckets_;
+  std::uint64_t last_key_ = 0;
+  std::size_t size_ = 0;
+
+  // Moves the smallest entries into bucket 0 if it is empty
+  void Refill();
+
+  // Bit pattern of a non-negative cost, which orders the same way as the cost
+  static std::uint64_t GetKey(const double & cost);
+
+  std::size_t GetBucket(const std::uint64_t & key) const;
+};
+
+}  // namespace astar_path_planner
+
+#endif  // RADIX_HEAP_FRONTIER_HPP_
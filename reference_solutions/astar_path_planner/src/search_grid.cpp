@@ -0,0 +1,57 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "search_grid.hpp"
+#include <cmath>
+
+namespace astar_path_planner
+{
+
+SearchGrid::SearchGrid(const nav2_costmap_2d::Costmap2D & costmap, const double & grid_size)
+: origin_x_(costmap.getOriginX()),
+  origin_y_(costmap.getOriginY()),
+  grid_size_(grid_size)
+{
+  const auto costmap_size_x = costmap.getSizeInCellsX() * costmap.getResolution();
+  const auto costmap_size_y = costmap.getSizeInCellsY() * costmap.getResolution();
+  size_x_ = static_cast<int>(std::floor(costmap_size_x / grid_size_));
+  size_y_ = static_cast<int>(std::floor(costmap_size_y / grid_size_));
+}
+
+bool SearchGrid::PointToCell(const Point & point, Cell & cell) const
+{
+  const auto x = static_cast<int>(std::floor((point.x() - origin_x_) / grid_size_));
+  const auto y = static_cast<int>(std::floor((point.y() - origin_y_) / grid_size_));
+  if (!IsInBounds(x, y)) {
+    return false;
+  }
+  cell = GetCell(x, y);
+  return true;
+}
+
+Point SearchGrid::CellToPoint(const Cell & cell) const
+{
+  return {
+    origin_x_ + (GetX(cell) + 0.5) * grid_size_,
+    origin_y_ + (GetY(cell) + 0.5) * grid_size_
+  };
+}
+
+}  // namespace astar_path_planner
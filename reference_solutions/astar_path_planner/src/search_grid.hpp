@@ -0,0 +1,105 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef SEARCH_GRID_HPP_
+#define SEARCH_GRID_HPP_
+
+#include <cstddef>
+#include <nav2_costmap_2d/costmap_2d.hpp>
+#include "utils.hpp"
+
+namespace astar_path_planner
+{
+
+using Cell = std::size_t;
+
+// Integer lattice of grid_size spaced cells covering the costmap, anchored at the costmap origin.
+// Cells are identified by a flat row-major index so per-cell search state can live in plain arrays.
+class SearchGrid
+{
+public:
+  SearchGrid() = default;
+
+  SearchGrid(const nav2_costmap_2d::Costmap2D & costmap, const double & grid_size);
+
+  int GetSizeX() const
+  {
+    return size_x_;
+  }
+
+  int GetSizeY() const
+  {
+    return size_y_;
+  }
+
+  std::size_t GetCellCount() const
+  {
+    return static_cast<std::size_t>(size_x_) * size_y_;
+  }
+
+  double GetGridSize() const
+  {
+    return grid_size_;
+  }
+
+  Cell GetCell(const int & x, const int & y) const
+  {
+    return static_cast<Cell>(y) * size_x_ + x;
+  }
+
+  int GetX(const Cell & cell) const
+  {
+    return static_cast<int>(cell % size_x_);
+  }
+
+  int GetY(const Cell & cell) const
+  {
+    return static_cast<int>(cell / size_x_);
+  }
+
+  bool IsInBounds(const int & x, const int & y) const
+  {
+    return x >= 0 && y >= 0 && x < size_x_ && y < size_y_;
+  }
+
+  // True if both grids cover the same area with the same cells
+  bool HasSameLayout(const SearchGrid & other) const
+  {
+    return origin_x_ == other.origin_x_ && origin_y_ == other.origin_y_ &&
+           grid_size_ == other.grid_size_ && size_x_ == other.size_x_ && size_y_ == other.size_y_;
+  }
+
+  // Snaps a world point to the nearest cell. Returns false if the point is off the grid.
+  bool PointToCell(const Point & point, Cell & cell) const;
+
+  // World position of the center of the given cell
+  Point CellToPoint(const Cell & cell) const;
+
+private:
+  double origin_x_ = 0.0;
+  double origin_y_ = 0.0;
+  double grid_size_ = 1.0;
+  int size_x_ = 0;
+  int size_y_ = 0;
+};
+
+}  // namespace astar_path_planner
+
+#endif  // SEARCH_GRID_HPP_
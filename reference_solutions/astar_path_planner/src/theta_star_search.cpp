@@ -0,0 +1,135 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "theta_star_search.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace astar_path_planner
+{
+
+ThetaStarSearch::ThetaStarSearch(const PlanningContext & context)
+: context_(context)
+{
+}
+
+std::vector<Cell> ThetaStarSearch::Search(
+  const Cell & start, const Cell & goal,
+  std::vector<bool> & expanded)
+{
+  const auto & grid = context_.GetGrid();
+  const auto & collision_map = context_.GetCollisionMap();
+  goal_ = goal;
+  path_costs_.assign(grid.GetCellCount(), std::numeric_limits<double>::infinity());
+  parents_.resize(grid.GetCellCount());
+  expanded.assign(grid.GetCellCount(), false);
+
+  FrontierQueue frontier;
+  path_costs_[start] = 0.0;
+  parents_[start] = start;
+  frontier.push({start, GetDistance(start, goal_), 0.0});
+
+  while (!frontier.empty()) {
+    const auto entry = frontier.top();
+    frontier.pop();
+
+    if (expanded[entry.cell]) {
+      continue;
+    }
+
+    SetVertex(entry.cell, expanded);
+    expanded[entry.cell] = true;
+
+    if (entry.cell == goal_) {
+      return ReconstructPath(entry.cell);
+    }
+
+    // Optimistically route every neighbor straight from this cell's parent
+    const auto parent = parents_[entry.cell];
+    const auto x = grid.GetX(entry.cell);
+    const auto y = grid.GetY(entry.cell);
+    for (const auto & move : context_.GetMoves()) {
+      if (!grid.IsInBounds(x + move.dx, y + move.dy)) {
+        continue;
+      }
+      const Cell next_cell = entry.cell + move.offset;
+      if (expanded[next_cell] || collision_map.IsCellInCollision(next_cell)) {
+        continue;
+      }
+      const auto new_path_cost = path_costs_[parent] + GetDistance(parent, next_cell);
+      if (new_path_cost >= path_costs_[next_cell]) {
+        continue;
+      }
+      path_costs_[next_cell] = new_path_cost;
+      parents_[next_cell] = parent;
+      frontier.push({next_cell, new_path_cost + GetDistance(next_cell, goal_), new_path_cost});
+    }
+  }
+
+  return {};
+}
+
+void ThetaStarSearch::SetVertex(const Cell & cell, const std::vector<bool> & expanded)
+{
+  if (context_.HasLineOfSight(parents_[cell], cell)) {
+    return;
+  }
+  const auto & grid = context_.GetGrid();
+  const auto x = grid.GetX(cell);
+  const auto y = grid.GetY(cell);
+  path_costs_[cell] = std::numeric_limits<double>::infinity();
+  for (const auto & move : context_.GetMoves()) {
+    if (!grid.IsInBounds(x + move.dx, y + move.dy)) {
+      continue;
+    }
+    const Cell neighbor = cell + move.offset;
+    if (!expanded[neighbor]) {
+      continue;
+    }
+    const auto path_cost = path_costs_[neighbor] + move.distance;
+    if (path_cost < path_costs_[cell]) {
+      path_costs_[cell] = path_cost;
+      parents_[cell] = neighbor;
+    }
+  }
+}
+
+double ThetaStarSearch::GetDistance(const Cell & from, const Cell & to) const
+{
+  const auto & grid = context_.GetGrid();
+  const auto dx = grid.GetX(to) - grid.GetX(from);
+  const auto dy = grid.GetY(to) - grid.GetY(from);
+  return grid.GetGridSize() * std::hypot(dx, dy);
+}
+
+std::vector<Cell> ThetaStarSearch::ReconstructPath(Cell cell) const
+{
+  std::vector<Cell> path{cell};
+  while (parents_[cell] != cell) {
+    cell = parents_[cell];
+    path.push_back(cell);
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+}  // namespace astar_path_planner
@@ -0,0 +1,66 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef THETA_STAR_SEARCH_HPP_
+#define THETA_STAR_SEARCH_HPP_
+
+#include <queue>
+#include <vector>
+#include "planning_context.hpp"
+#include "search_grid.hpp"
+#include "utils.hpp"
+
+namespace astar_path_planner
+{
+
+// Lazy Theta* (Nash, Koenig & Tovey, 2010) any-angle search over the search grid.
+// A cell may take any earlier cell with line of sight as its parent, so paths are made of straight
+// segments between a few waypoints instead of 45 degree steps between neighboring cells.
+// Line of sight is only checked when a cell is expanded, keeping the checks per expansion to one.
+class ThetaStarSearch
+{
+public:
+  explicit ThetaStarSearch(const PlanningContext & context);
+
+  // Returns the waypoint cells of a path from start to goal, or an empty vector if there is none.
+  // Every expanded cell is marked in `expanded`.
+  std::vector<Cell> Search(const Cell & start, const Cell & goal, std::vector<bool> & expanded);
+
+private:
+  using FrontierQueue = std::priority_queue<FrontierEntry, std::vector<FrontierEntry>,
+      FrontierEntryComparator>;
+
+  const PlanningContext & context_;
+  Cell goal_;
+  std::vector<double> path_costs_;
+  std::vector<Cell> parents_;
+
+  // Called when a cell is expanded. If its assumed parent is not actually visible, falls back to
+  // the best already expanded neighbor as in plain A*.
+  void SetVertex(const Cell & cell, const std::vector<bool> & expanded);
+
+  double GetDistance(const Cell & from, const Cell & to) const;
+
+  std::vector<Cell> ReconstructPath(Cell cell) const;
+};
+
+}  // namespace astar_path_planner
+
+#endif  // THETA_STAR_SEARCH_HPP_
@@ -21,6 +21,7 @@
 #include "utils.hpp"
 #include <algorithm>
 #include <vector>
+#include <nav2_costmap_2d/cost_values.hpp>
 
 namespace astar_path_planner
 {
@@ -43,6 +44,17 @@ bool FrontierEntryComparator::operator()(const FrontierEntry & a, const Frontier
   return a.cost > b.cost;
 }
 
+CostScaleTable MakeCostScaleTable(const double & cost_weight)
+{
+  constexpr auto kMaxCost = static_cast<double>(nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE - 1);
+  CostScaleTable table;
+  for (std::size_t cost = 0; cost < table.size(); ++cost) {
+    table[cost] = 1.0 + cost_weight * std::min(cost / kMaxCost, 1.0);
+  }
+  table[nav2_costmap_2d::NO_INFORMATION] = 1.0;
+  return table;
+}
+
 std::vector<nav2_costmap_2d::MapLocation> PolygonForCircle(
   const nav2_costmap_2d::Costmap2D & costmap,
   const Point & center,
@@ -22,6 +22,7 @@
 #define UTILS_HPP_
 
 #include <Eigen/Dense>
+#include <array>
 #include <vector>
 #include <nav2_costmap_2d/costmap_2d.hpp>
 
@@ -40,10 +41,20 @@ struct PointHash
   std::size_t operator()(const Point & point) const;
 };
 
+struct GridMove
+{
+  int dx;
+  int dy;
+  // Change in flat cell index for this move
+  std::ptrdiff_t offset;
+  double distance;
+};
+
 struct FrontierEntry
 {
-  std::vector<Point> path;
+  std::size_t cell;
   double cost;
+  double path_cost;
 };
 
 struct FrontierEntryComparator
@@ -51,6 +62,13 @@ struct FrontierEntryComparator
   bool operator()(const FrontierEntry & a, const FrontierEntry & b) const;
 };
 
+// Step length multiplier for each costmap cost of the cell a move enters
+using CostScaleTable = std::array<double, 256>;
+
+// Scales steps by 1 + cost_weight * cost / 252, so paths trade length for clearance from
+// inflated obstacles. Unknown cells add no cost. A weight of 0 gives plain path length.
+CostScaleTable MakeCostScaleTable(const double & cost_weight);
+
 std::vector<nav2_costmap_2d::MapLocation> PolygonForCircle(
   const nav2_costmap_2d::Costmap2D & costmap,
   const Point & center,
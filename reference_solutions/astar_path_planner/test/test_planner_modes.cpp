@@ -0,0 +1,264 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nav2_costmap_2d/cost_values.hpp>
+#include <nav2_costmap_2d/costmap_2d.hpp>
+#include "astar_path_planner.hpp"
+#include "dstar_lite_planner.hpp"
+#include "planning_context.hpp"
+#include "utils.hpp"
+
+namespace astar_path_planner
+{
+
+namespace
+{
+
+constexpr double kCostTolerance = 1e-6;
+constexpr double kResolution = 0.05;
+constexpr unsigned int kMapCells = 40;
+
+struct Query
+{
+  Point start;
+  Point goal;
+};
+
+struct TestMap
+{
+  std::string name;
+  std::shared_ptr<const PlanningContext> context;
+  std::vector<Query> queries;
+};
+
+void FillRectangle(
+  nav2_costmap_2d::Costmap2D & costmap, const unsigned int min_x, const unsigned int min_y,
+  const unsigned int max_x, const unsigned int max_y, const unsigned char cost)
+{
+  for (auto y = min_y; y <= max_y; ++y) {
+    for (auto x = min_x; x <= max_x; ++x) {
+      costmap.setCost(x, y, cost);
+    }
+  }
+}
+
+// Fixed start and goal cells spread over the map, keeping only those clear of obstacles
+TestMap MakeTestMap(const std::string & name, const nav2_costmap_2d::Costmap2D & costmap)
+{
+  TestMap map{name, std::make_shared<PlanningContext>(costmap, kResolution, kResolution), {}};
+  const auto & grid = map.context->GetGrid();
+  const std::vector<std::vector<int>> pairs{
+    {4, 4, 35, 35}, {4, 35, 35, 4}, {4, 20, 35, 20}, {10, 5, 30, 30}, {35, 14, 6, 30},
+    {25, 25, 26, 27}};
+  for (const auto & pair : pairs) {
+    const auto start = grid.GetCell(pair[0], pair[1]);
+    const auto goal = grid.GetCell(pair[2], pair[3]);
+    const auto & collision_map = map.context->GetCollisionMap();
+    if (!collision_map.IsCellInCollision(start) && !collision_map.IsCellInCollision(goal)) {
+      map.queries.push_back({grid.CellToPoint(start), grid.CellToPoint(goal)});
+    }
+  }
+  return map;
+}
+
+// 2 m square maps with a lethal border: an open field, a wall with a gap and a pair of walls with
+// an inflated band along them
+std::vector<TestMap> MakeTestMaps()
+{
+  using nav2_costmap_2d::LETHAL_OBSTACLE;
+  nav2_costmap_2d::Costmap2D costmap(kMapCells, kMapCells, kResolution, 0.0, 0.0);
+  FillRectangle(costmap, 0, 0, kMapCells - 1, 0, LETHAL_OBSTACLE);
+  FillRectangle(costmap, 0, kMapCells - 1, kMapCells - 1, kMapCells - 1, LETHAL_OBSTACLE);
+  FillRectangle(costmap, 0, 0, 0, kMapCells - 1, LETHAL_OBSTACLE);
+  FillRectangle(costmap, kMapCells - 1, 0, kMapCells - 1, kMapCells - 1, LETHAL_OBSTACLE);
+  std::vector<TestMap> maps{MakeTestMap("open", costmap)};
+
+  FillRectangle(costmap, 19, 0, 20, 30, LETHAL_OBSTACLE);
+  maps.push_back(MakeTestMap("wall", costmap));
+
+  FillRectangle(costmap, 21, 10, 32, 11, LETHAL_OBSTACLE);
+  FillRectangle(costmap, 15, 0, 17, 32, 150);
+  FillRectangle(costmap, 22, 13, 34, 15, 150);
+  maps.push_back(MakeTestMap("walls", costmap));
+  return maps;
+}
+
+std::vector<Point> Plan(
+  const TestMap & map, const Query & query, const std::string & mode,
+  const double cost_weight = 0.0)
+{
+  PlannerParameters parameters;
+  parameters.planner_mode = mode;
+  parameters.goal_threshold = 0.0;
+  parameters.cost_weight = cost_weight;
+  AStarPathPlanner planner(parameters, map.context);
+  return planner.Plan(query.start, query.goal);
+}
+
+double GetOptimalCost(const TestMap & map, const Query & query, const double cost_weight = 0.0)
+{
+  PlannerParameters parameters;
+  parameters.cost_weight = cost_weight;
+  AStarPathPlanner planner(parameters, map.context);
+  return planner.GetPathCosts(query.start, {query.goal}).front();
+}
+
+// Scales each step by the cost of the cell it enters, as the searches do. Sparse paths only have
+// a meaningful cost with a cost weight of 0, where this is their length.
+double GetPathCost(const TestMap & map, const std::vector<Point> & path, const double cost_weight)
+{
+  const auto cost_scale = MakeCostScaleTable(cost_weight);
+  const auto & grid = map.context->GetGrid();
+  double cost = 0.0;
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    Cell cell;
+    EXPECT_TRUE(grid.PointToCell(path[i], cell));
+    cost += (path[i] - path[i - 1]).norm() * cost_scale[map.context->GetCellCost(cell)];
+  }
+  return cost;
+}
+
+double GetPathLength(const TestMap & map, const std::vector<Point> & path)
+{
+  return GetPathCost(map, path, 0.0);
+}
+
+}  // namespace
+
+TEST(PlannerModes, OptimalModesMatchAStarCost)
+{
+  for (const auto & map : MakeTestMaps()) {
+    DStarLitePlanner incremental_planner;
+    for (const auto & query : map.queries) {
+      SCOPED_TRACE(map.name);
+      const auto astar_path = Plan(map, query, "astar");
+      ASSERT_FALSE(astar_path.empty());
+      const auto cost = GetPathLength(map, astar_path);
+      EXPECT_NEAR(GetOptimalCost(map, query), cost, kCostTolerance);
+
+      for (const auto & mode : {"bidirectional", "jps"}) {
+        SCOPED_TRACE(mode);
+        const auto path = Plan(map, query, mode);
+        ASSERT_FALSE(path.empty());
+        EXPECT_NEAR(cost, GetPathLength(map, path), kCostTolerance);
+      }
+
+      PlannerParameters parameters;
+      parameters.goal_threshold = 0.0;
+      BasicAStarPathPlanner<RadixHeapFrontier> radix_planner(parameters, map.context);
+      EXPECT_NEAR(
+        cost, GetPathLength(map, radix_planner.Plan(query.start, query.goal)), kCostTolerance);
+
+      // Kept across queries, so later plans to a repeated goal reuse the search
+      const auto incremental_path = incremental_planner.Plan(map.context, query.start, query.goal);
+      EXPECT_NEAR(cost, GetPathLength(map, incremental_path), kCostTolerance);
+    }
+  }
+}
+
+TEST(PlannerModes, CostWeightedModesMatchAStarCost)
+{
+  constexpr double kCostWeight = 2.0;
+  for (const auto & map : MakeTestMaps()) {
+    for (const auto & query : map.queries) {
+      SCOPED_TRACE(map.name);
+      const auto cost = GetOptimalCost(map, query, kCostWeight);
+      for (const auto & mode : {"astar", "bidirectional"}) {
+        SCOPED_TRACE(mode);
+        const auto path = Plan(map, query, mode, kCostWeight);
+        ASSERT_FALSE(path.empty());
+        EXPECT_NEAR(cost, GetPathCost(map, path, kCostWeight), kCostTolerance);
+      }
+    }
+  }
+}
+
+TEST(PlannerModes, SuboptimalModesFindValidPaths)
+{
+  for (const auto & map : MakeTestMaps()) {
+    for (const auto & query : map.queries) {
+      SCOPED_TRACE(map.name);
+      const auto cost = GetOptimalCost(map, query);
+
+      // Any-angle paths can cut corners of the grid path, but never beat the straight line
+      const auto theta_star_path = Plan(map, query, "theta_star");
+      ASSERT_FALSE(theta_star_path.empty());
+      const auto theta_star_length = GetPathLength(map, theta_star_path);
+      EXPECT_LE(theta_star_length, cost + kCostTolerance);
+      EXPECT_GE(theta_star_length, (query.goal - query.start).norm() - kCostTolerance);
+
+      const auto hierarchical_path = Plan(map, query, "hierarchical");
+      ASSERT_FALSE(hierarchical_path.empty());
+      EXPECT_GE(GetPathLength(map, hierarchical_path), cost - kCostTolerance);
+    }
+  }
+}
+
+TEST(PlannerModes, AnytimeCostsStayWithinBound)
+{
+  constexpr double kInitialWeight = 3.0;
+  for (const auto & map : MakeTestMaps()) {
+    for (const auto & query : map.queries) {
+      SCOPED_TRACE(map.name);
+      const auto cost = GetOptimalCost(map, query);
+      PlannerParameters parameters;
+      parameters.planner_mode = "anytime";
+      parameters.goal_threshold = 0.0;
+      parameters.anytime_initial_weight = kInitialWeight;
+
+      // Without time to improve, whatever the first weighted search reached comes back. The
+      // deadline is only checked every few hundred expansions, so on the open map that search
+      // always finishes and its path is within the initial weight.
+      parameters.planning_deadline = 0.0;
+      AStarPathPlanner first_planner(parameters, map.context);
+      const auto first_path = first_planner.Plan(query.start, query.goal);
+      if (map.name == "open") {
+        ASSERT_FALSE(first_path.empty());
+        EXPECT_LE(first_planner.GetSuboptimalityBound(), kInitialWeight);
+      }
+      if (!first_path.empty()) {
+        EXPECT_LE(
+          GetPathLength(map, first_path),
+          first_planner.GetSuboptimalityBound() * cost + kCostTolerance);
+      }
+
+      // With plenty of time, the search proves its path optimal
+      parameters.planning_deadline = 10.0;
+      AStarPathPlanner final_planner(parameters, map.context);
+      const auto final_path = final_planner.Plan(query.start, query.goal);
+      EXPECT_LE(final_planner.GetSuboptimalityBound(), 1.0);
+      EXPECT_NEAR(cost, GetPathLength(map, final_path), kCostTolerance);
+    }
+  }
+}
+
+TEST(PlannerModes, UnsupportedModesFindNoPath)
+{
+  const auto maps = MakeTestMaps();
+  const auto & map = maps.front();
+  EXPECT_TRUE(Plan(map, map.queries.front(), "incremental").empty());
+  EXPECT_TRUE(Plan(map, map.queries.front(), "no_such_mode").empty());
+}
+
+}  // namespace astar_path_planner
@@ -31,6 +31,8 @@ def generate_launch_description():
     # BEGIN STUDENT CODE
     parameters_file_path = os.path.join(get_package_share_directory(
         'localization'), 'config', 'localizer_params.yaml')
+    tag_map_file_path = os.path.join(get_package_share_directory(
+        'localization'), 'config', 'tag_map.yaml')
     # END STUDENT CODE
 
     return LaunchDescription([
@@ -41,6 +43,7 @@ def generate_launch_description():
             # BEGIN STUDENT CODE
             parameters=[
                 parameters_file_path,
+                LaunchConfiguration('tag_map', default=tag_map_file_path),
                 {'use_sim_time': LaunchConfiguration('use_sim_time', default='false')}
             ],
             # END STUDENT CODE
@@ -19,61 +19,45 @@
 // THE SOFTWARE.
 
 #include "aruco_sensor_model.hpp"
-#include <angles/angles.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <utility>
 
 namespace localization
 {
 
-ArucoSensorModel::ArucoSensorModel(rclcpp::Node & node)
+constexpr std::size_t kBlockSize = 64;
+constexpr double kTagHeightSquared = 0.05 * 0.05;
+
+ArucoSensorModel::ArucoSensorModel(rclcpp::Node & node, const MathKernels & math)
+: math_(math)
 {
   covariance_ = node.declare_parameter<std::vector<double>>(
     "sensors.aruco.covariance", {0.025, 0.025});
   timeout_ = node.declare_parameter<double>("sensors.aruco.measurement_timeout", 0.1);
 
-  tags_ = {
-    // side 1
-    {0, TagLocation{0.6096, 0, -M_PI_2}},
-    {1, TagLocation{0.6096, 0.11, -M_PI_2}},
-    {2, TagLocation{0.6096, 0.22, -M_PI_2}},
-    {3, TagLocation{0.6096, 0.33, -M_PI_2}},
-    {4, TagLocation{0.6096, -0.11, -M_PI_2}},
-    {5, TagLocation{0.6096, -0.22, -M_PI_2}},
-    {6, TagLocation{0.6096, -0.33, -M_PI_2}},
-    // side 2
-    {7, TagLocation{0.0, -0.381, M_PI}},
-    {8, TagLocation{0.11, -0.381, M_PI}},
-    {9, TagLocation{0.22, -0.381, M_PI}},
-    {13, TagLocation{0.33, -0.381, M_PI}},
-    {14, TagLocation{0.44, -0.381, M_PI}},
-    {15, TagLocation{0.55, -0.381, M_PI}},
-    {16, TagLocation{-0.11, -0.381, M_PI}},
-    {17, TagLocation{-0.22, -0.381, M_PI}},
-    {18, TagLocation{-0.33, -0.381, M_PI}},
-    {19, TagLocation{-0.44, -0.381, M_PI}},
-    {20, TagLocation{-0.55, -0.381, M_PI}},
-    // side 3
-    {21, TagLocation{-0.6096, 0, M_PI_2}},
-    {22, TagLocation{-0.6096, 0.11, M_PI_2}},
-    {23, TagLocation{-0.6096, 0.22, M_PI_2}},
-    {24, TagLocation{-0.6096, 0.33, M_PI_2}},
-    {25, TagLocation{-0.6096, -0.11, M_PI_2}},
-    {26, TagLocation{-0.6096, -0.22, M_PI_2}},
-    {27, TagLocation{-0.6096, -0.33, M_PI_2}},
-    // side 4
-    {28, TagLocation{0.0, 0.381, 0}},
-    {29, TagLocation{0.11, 0.381, 0}},
-    {30, TagLocation{0.22, 0.381, 0}},
-    {31, TagLocation{0.33, 0.381, 0}},
-    {32, TagLocation{0.44, 0.381, 0}},
-    {33, TagLocation{0.55, 0.381, 0}},
-    {34, TagLocation{-0.11, 0.381, 0}},
-    {35, TagLocation{-0.22, 0.381, 0}},
-    {36, TagLocation{-0.33, 0.381, 0}},
-    {37, TagLocation{-0.44, 0.381, 0}},
-    {38, TagLocation{-0.55, 0.381, 0}},
-  };
+  LoadTagMap(node);
+
+  if (node.declare_parameter<bool>("sensors.aruco.lookup_table.enabled", false)) {
+    table_resolution_ = node.declare_parameter<double>(
+      "sensors.aruco.lookup_table.resolution", 0.01);
+    const auto margin = node.declare_parameter<double>("sensors.aruco.lookup_table.margin", 0.1);
+    const auto max_size_mb = node.declare_parameter<double>(
+      "sensors.aruco.lookup_table.max_size_mb", 64.0);
+    const auto table_bytes = BuildLookupTable(margin, static_cast<std::size_t>(max_size_mb * 1e6));
+    if (lookup_table_.empty()) {
+      RCLCPP_ERROR(
+        node.get_logger(),
+        "ArUco lookup table would take %.1f MB, over sensors.aruco.lookup_table.max_size_mb of "
+        "%.1f MB. Using the exact sensor model instead.", table_bytes / 1e6, max_size_mb);
+    }
+  }
 
   tag_sub_ = node.create_subscription<stsl_interfaces::msg::TagArray>(
     "/tags", 1, std::bind(&ArucoSensorModel::UpdateMeasurement, this, std::placeholders::_1));
@@ -82,48 +66,245 @@ ArucoSensorModel::ArucoSensorModel(rclcpp::Node & node)
 void ArucoSensorModel::UpdateMeasurement(const stsl_interfaces::msg::TagArray::SharedPtr msg)
 {
   last_msg_ = *msg;
+  measurements_.clear();
+  for (const stsl_interfaces::msg::Tag & tag : last_msg_.tags) {
+    // ensure this is a localization tag
+    const auto id = std::lower_bound(tag_ids_.begin(), tag_ids_.end(), tag.id);
+    if (id == tag_ids_.end() || *id != tag.id) {
+      continue;
+    }
+    TagMeasurement measurement;
+    measurement.tag_index = id - tag_ids_.begin();
+    measurement.map_location = tag_locations_[measurement.tag_index];
+    measurement.distance = sqrt(
+      pow(tag.pose.position.x, 2) + pow(tag.pose.position.y, 2) + pow(tag.pose.position.z, 2));
+    measurement.bearing = atan2(tag.pose.position.y, tag.pose.position.x);
+    measurements_.push_back(measurement);
+  }
+  measurement_sequence_++;
 }
 
-double ArucoSensorModel::ComputeLogNormalizer()
+double ArucoSensorModel::ComputeLogNormalizer() const
 {
   return log(sqrt(pow(2 * M_PI, 2))) +
          log(sqrt(covariance_[0])) + log(sqrt(covariance_[1]));
 }
 
-double ArucoSensorModel::ComputeLogProb(const Particle & particle)
+void ArucoSensorModel::AccumulateLogWeights(
+  const ParticleSpan & particles,
+  double * log_weights) const
 {
-  double log_prob = 0;
-  for (const stsl_interfaces::msg::Tag & tag : last_msg_.tags) {
-    TagLocation body_location;
-    // ensure this is a localization tag
-    if (tags_.find(tag.id) == tags_.end()) {
-      continue;
+  if (!lookup_table_.empty()) {
+    AccumulateLogWeightsFromTable(particles, log_weights);
+    return;
+  }
+  // Particles are scored in blocks so each yaw's sine and cosine is computed once per update
+  const double distance_information = 1.0 / covariance_[0];
+  const double bearing_information = 1.0 / covariance_[1];
+  const double log_normalizer = ComputeLogNormalizer();
+
+  for (std::size_t block_begin = 0; block_begin < particles.size; block_begin += kBlockSize) {
+    const std::size_t block_size = std::min(kBlockSize, particles.size - block_begin);
+    const double * x = particles.x + block_begin;
+    const double * y = particles.y + block_begin;
+    const double * yaw = particles.yaw + block_begin;
+    double cos_yaw[kBlockSize];
+    double sin_yaw[kBlockSize];
+    double body_x[kBlockSize];
+    double body_y[kBlockSize];
+    double expected_bearing[kBlockSize];
+    double squared_error[kBlockSize];
+    math_.sin_cos(yaw, sin_yaw, cos_yaw, block_size);
+    for (std::size_t i = 0; i < block_size; i++) {
+      squared_error[i] = 0.0;
+    }
+
+    for (const TagMeasurement & measurement : measurements_) {
+      for (std::size_t i = 0; i < block_size; i++) {
+        // convert the global location of the tag into body frame
+        const double x_diff = measurement.map_location.x - x[i];
+        const double y_diff = measurement.map_location.y - y[i];
+        // rotation matrix is transposed
+        body_x[i] = x_diff * cos_yaw[i] - y_diff * sin_yaw[i];
+        body_y[i] = x_diff * sin_yaw[i] + y_diff * cos_yaw[i];
+      }
+      math_.atan2(body_y, body_x, expected_bearing, block_size);
+      for (std::size_t i = 0; i < block_size; i++) {
+        const double expected_dist =
+          sqrt(body_x[i] * body_x[i] + body_y[i] * body_y[i] + kTagHeightSquared);
+        const double distance_error = expected_dist - measurement.distance;
+        const double angular_error = WrapAngle(measurement.bearing - expected_bearing[i]);
+        squared_error[i] += distance_error * distance_error * distance_information +
+          angular_error * angular_error * bearing_information;
+      }
+    }
+
+    for (std::size_t i = 0; i < block_size; i++) {
+      log_weights[block_begin + i] += -0.5 * squared_error[i] - log_normalizer;
+    }
+  }
+}
+
+void ArucoSensorModel::LoadTagMap(rclcpp::Node & node)
+{
+  const auto ids = node.declare_parameter<std::vector<std::int64_t>>(
+    "sensors.aruco.tag_map.ids", std::vector<std::int64_t>{});
+  const auto x = node.declare_parameter<std::vector<double>>(
+    "sensors.aruco.tag_map.x", std::vector<double>{});
+  const auto y = node.declare_parameter<std::vector<double>>(
+    "sensors.aruco.tag_map.y", std::vector<double>{});
+  const auto yaw = node.declare_parameter<std::vector<double>>(
+    "sensors.aruco.tag_map.yaw", std::vector<double>{});
+  // Without a map every particle would get the same tag weight, leaving the filter to run on
+  // odometry alone, so a missing or broken map stops the node instead
+  if (ids.empty()) {
+    throw std::runtime_error{"Tag map is empty. Set the sensors.aruco.tag_map.* parameters."};
+  }
+  if (x.size() != ids.size() || y.size() != ids.size() || yaw.size() != ids.size()) {
+    throw std::runtime_error{"Incorrect tag map. ids, x, y and yaw must have the same length."};
+  }
+
+  std::vector<std::size_t> order(ids.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(
+    order.begin(), order.end(),
+    [&ids](const std::size_t a, const std::size_t b) {return ids[a] < ids[b];});
+  tag_ids_.reserve(ids.size());
+  tag_locations_.reserve(ids.size());
+  for (const std::size_t i : order) {
+    if (ids[i] < 0 || ids[i] > std::numeric_limits<int>::max()) {
+      throw std::runtime_error{"Tag map id " + std::to_string(ids[i]) + " is out of range."};
+    }
+    if (!tag_ids_.empty() && tag_ids_.back() == ids[i]) {
+      throw std::runtime_error{"Tag map id " + std::to_string(ids[i]) + " is listed twice."};
     }
-    // convert the global location of the current tag id into body frame
-    TagLocation map_location = tags_.at(tag.id);
-    double x_diff = map_location.x - particle.x;
-    double y_diff = map_location.y - particle.y;
+    tag_ids_.push_back(static_cast<int>(ids[i]));
+    tag_locations_.push_back(TagLocation{x[i], y[i], yaw[i]});
+  }
+}
+
+std::size_t ArucoSensorModel::BuildLookupTable(const double margin, const std::size_t max_bytes)
+{
+  lookup_table_.clear();
+  double max_x = tag_locations_.front().x;
+  double max_y = tag_locations_.front().y;
+  table_min_x_ = max_x;
+  table_min_y_ = max_y;
+  for (const TagLocation & location : tag_locations_) {
+    table_min_x_ = std::min(table_min_x_, location.x);
+    table_min_y_ = std::min(table_min_y_, location.y);
+    max_x = std::max(max_x, location.x);
+    max_y = std::max(max_y, location.y);
+  }
+  table_min_x_ -= margin;
+  table_min_y_ -= margin;
+  const auto to_point_count = [this](const double length) {
+      return static_cast<int>(std::ceil(length / table_resolution_)) + 1;
+    };
+  table_size_x_ = to_point_count(max_x + margin - table_min_x_);
+  table_size_y_ = to_point_count(max_y + margin - table_min_y_);
 
-    // rotation matrix is transposed
-    body_location.x = x_diff * cos(particle.yaw) - y_diff * sin(particle.yaw);
-    body_location.y = x_diff * sin(particle.yaw) + y_diff * cos(particle.yaw);
+  const std::size_t point_count = static_cast<std::size_t>(table_size_x_) * table_size_y_;
+  const std::size_t entry_count = 2 * point_count * tag_locations_.size();
+  const std::size_t table_bytes = entry_count * sizeof(float);
+  if (table_bytes > max_bytes) {
+    return table_bytes;
+  }
+  lookup_table_.resize(entry_count);
+  float * entry = lookup_table_.data();
+  for (const TagLocation & location : tag_locations_) {
+    for (int grid_y = 0; grid_y < table_size_y_; grid_y++) {
+      const double y_diff = location.y - (table_min_y_ + grid_y * table_resolution_);
+      for (int grid_x = 0; grid_x < table_size_x_; grid_x++) {
+        const double x_diff = location.x - (table_min_x_ + grid_x * table_resolution_);
+        *entry++ = sqrt(x_diff * x_diff + y_diff * y_diff + kTagHeightSquared);
+        *entry++ = atan2(y_diff, x_diff);
+      }
+    }
+  }
+  return table_bytes;
+}
 
-    double expected_dist = sqrt(pow(body_location.x, 2) + pow(body_location.y, 2) + pow(0.05, 2));
-    double dist =
-      sqrt(
-      pow(
-        tag.pose.position.x,
-        2) + pow(tag.pose.position.y, 2) + pow(tag.pose.position.z, 2));
+void ArucoSensorModel::AccumulateLogWeightsFromTable(
+  const ParticleSpan & particles,
+  double * log_weights) const
+{
+  const double distance_information = 1.0 / covariance_[0];
+  const double bearing_information = 1.0 / covariance_[1];
+  const double log_normalizer = ComputeLogNormalizer();
+  const std::size_t tag_stride = 2 * static_cast<std::size_t>(table_size_x_) * table_size_y_;
+  const std::size_t row_stride = 2 * static_cast<std::size_t>(table_size_x_);
 
-    log_prob += pow(expected_dist - dist, 2) / covariance_[0];
+  for (std::size_t block_begin = 0; block_begin < particles.size; block_begin += kBlockSize) {
+    const std::size_t block_size = std::min(kBlockSize, particles.size - block_begin);
+    const double * x = particles.x + block_begin;
+    const double * y = particles.y + block_begin;
+    const double * yaw = particles.yaw + block_begin;
+    // Every tag's table shares the grid, so each particle's cell is found once per update
+    std::size_t offset[kBlockSize];
+    double x_fraction[kBlockSize];
+    double y_fraction[kBlockSize];
+    bool in_table[kBlockSize];
+    double squared_error[kBlockSize];
+    for (std::size_t i = 0; i < block_size; i++) {
+      const double grid_x = (x[i] - table_min_x_) / table_resolution_;
+      const double grid_y = (y[i] - table_min_y_) / table_resolution_;
+      const double cell_x = std::floor(grid_x);
+      const double cell_y = std::floor(grid_y);
+      in_table[i] = cell_x >= 0 && cell_y >= 0 && cell_x < table_size_x_ - 1 &&
+        cell_y < table_size_y_ - 1;
+      offset[i] = in_table[i] ?
+        static_cast<std::size_t>(cell_y) * row_stride + 2 * static_cast<std::size_t>(cell_x) : 0;
+      x_fraction[i] = grid_x - cell_x;
+      y_fraction[i] = grid_y - cell_y;
+      squared_error[i] = 0.0;
+    }
 
-    double bearing = atan2(tag.pose.position.y, tag.pose.position.x);
-    double expected_bearing = atan2(body_location.y, body_location.x);
+    for (const TagMeasurement & measurement : measurements_) {
+      const float * tag_table = lookup_table_.data() + measurement.tag_index * tag_stride;
+      for (std::size_t i = 0; i < block_size; i++) {
+        double expected_dist;
+        double expected_bearing;
+        if (in_table[i]) {
+          const float * corner_00 = tag_table + offset[i];
+          const float * corner_10 = corner_00 + 2;
+          const float * corner_01 = corner_00 + row_stride;
+          const float * corner_11 = corner_01 + 2;
+          const double fx = x_fraction[i];
+          const double fy = y_fraction[i];
+          const double w00 = (1 - fx) * (1 - fy);
+          const double w10 = fx * (1 - fy);
+          const double w01 = (1 - fx) * fy;
+          const double w11 = fx * fy;
+          expected_dist = w00 * corner_00[0] + w10 * corner_10[0] + w01 * corner_01[0] +
+            w11 * corner_11[0];
+          // Bearings are interpolated as offsets from one corner so the wrap at +-pi can't split a
+          // cell. Neighboring grid points are close enough that offsets only leave [-pi, pi] there.
+          const double base_bearing = corner_00[1];
+          const auto unwrap = [base_bearing](const double bearing) {
+              const double difference = bearing - base_bearing;
+              return difference > M_PI ? difference - 2 * M_PI :
+                     difference < -M_PI ? difference + 2 * M_PI : difference;
+            };
+          expected_bearing = base_bearing + yaw[i] +
+            w10 * unwrap(corner_10[1]) + w01 * unwrap(corner_01[1]) + w11 * unwrap(corner_11[1]);
+        } else {
+          const double x_diff = measurement.map_location.x - x[i];
+          const double y_diff = measurement.map_location.y - y[i];
+          expected_dist = sqrt(x_diff * x_diff + y_diff * y_diff + kTagHeightSquared);
+          expected_bearing = atan2(y_diff, x_diff) + yaw[i];
+        }
+        const double distance_error = expected_dist - measurement.distance;
+        const double angular_error = WrapAngle(measurement.bearing - expected_bearing);
+        squared_error[i] += distance_error * distance_error * distance_information +
+          angular_error * angular_error * bearing_information;
+      }
+    }
 
-    const auto angular_error = angles::shortest_angular_distance(expected_bearing, bearing);
-    log_prob += pow(angular_error, 2) / covariance_[1];
+    for (std::size_t i = 0; i < block_size; i++) {
+      log_weights[block_begin + i] += -0.5 * squared_error[i] - log_normalizer;
+    }
   }
-  return log_prob;
 }
 
 bool ArucoSensorModel::IsMeasurementAvailable(const rclcpp::Time & cur_time)
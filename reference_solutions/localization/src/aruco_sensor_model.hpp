@@ -21,9 +21,11 @@
 #ifndef ARUCO_SENSOR_MODEL_HPP_
 #define ARUCO_SENSOR_MODEL_HPP_
 
-#include <map>
+#include <cstddef>
+#include <vector>
 #include <tf2_geometry_msgs/tf2_geometry_msgs.hpp>
 #include <stsl_interfaces/msg/tag_array.hpp>
+#include "fast_math.hpp"
 #include "sensor_model.hpp"
 
 namespace localization
@@ -36,19 +38,56 @@ struct TagLocation
   double yaw = 0;
 };
 
+// A detected tag with a known map location, with the values every particle compares against
+struct TagMeasurement
+{
+  TagLocation map_location;
+  // Position of the tag in tag_locations_, which is also its slot in the lookup table
+  std::size_t tag_index;
+  double distance;
+  double bearing;
+};
+
 class ArucoSensorModel : public SensorModel
 {
 public:
-  explicit ArucoSensorModel(rclcpp::Node & node);
+  ArucoSensorModel(rclcpp::Node & node, const MathKernels & math);
   void UpdateMeasurement(const stsl_interfaces::msg::TagArray::SharedPtr msg);
-  double ComputeLogProb(const Particle & particle) override;
-  double ComputeLogNormalizer() override;
+  void AccumulateLogWeights(const ParticleSpan & particles, double * log_weights) const override;
+  double ComputeLogNormalizer() const override;
   bool IsMeasurementAvailable(const rclcpp::Time & cur_time) override;
 
 private:
+  const MathKernels & math_;
   stsl_interfaces::msg::TagArray last_msg_;
   rclcpp::Subscription<stsl_interfaces::msg::TagArray>::SharedPtr tag_sub_;
-  std::map<int, TagLocation> tags_;
+  // Known tags sorted by id and stored contiguously. tag_ids_[i] is the id of tag_locations_[i],
+  // so detections are looked up with a binary search whatever the ids' range.
+  std::vector<TagLocation> tag_locations_;
+  std::vector<int> tag_ids_;
+  // Known tags in last_msg_, prepared once per message instead of once per particle
+  std::vector<TagMeasurement> measurements_;
+
+  // Optional grid over the tags' bounding box holding each tag's expected distance and map frame
+  // bearing at every grid point, interleaved per point and stored tag by tag. Yaw only rotates the
+  // bearing, so it is added per particle instead of being part of the grid.
+  double table_resolution_ = 0;
+  double table_min_x_ = 0;
+  double table_min_y_ = 0;
+  int table_size_x_ = 0;
+  int table_size_y_ = 0;
+  std::vector<float> lookup_table_;
+
+  // Reads the sensors.aruco.tag_map.* parameters, which hold one entry per tag in each list.
+  // Throws std::runtime_error if the map is empty or invalid.
+  void LoadTagMap(rclcpp::Node & node);
+
+  // Returns the table's size in bytes, leaving lookup_table_ empty if that is over max_bytes
+  std::size_t BuildLookupTable(const double margin, const std::size_t max_bytes);
+
+  // Scores particles by interpolating lookup_table_, falling back to the exact model for particles
+  // outside of the table
+  void AccumulateLogWeightsFromTable(const ParticleSpan & particles, double * log_weights) const;
 };
 }  // namespace localization
 
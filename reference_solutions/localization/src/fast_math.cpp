@@ -0,0 +1,128 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "fast_math.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "fast_math_kernels.hpp"
+
+namespace localization
+{
+
+namespace
+{
+
+struct ScalarOps
+{
+  using Vector = double;
+  using Mask = bool;
+  static constexpr std::size_t kWidth = 1;
+
+  static Vector Load(const double * source) {return *source;}
+  static void Store(double * destination, const Vector value) {*destination = value;}
+  static Vector Set(const double value) {return value;}
+  static Vector Add(const Vector a, const Vector b) {return a + b;}
+  static Vector Sub(const Vector a, const Vector b) {return a - b;}
+  static Vector Mul(const Vector a, const Vector b) {return a * b;}
+  static Vector Div(const Vector a, const Vector b) {return a / b;}
+  static Vector Fma(const Vector a, const Vector b, const Vector c) {return a * b + c;}
+  static Vector Round(const Vector value) {return std::nearbyint(value);}
+  static Vector Floor(const Vector value) {return std::floor(value);}
+  static Vector Abs(const Vector value) {return std::fabs(value);}
+  static Vector Min(const Vector a, const Vector b) {return a < b ? a : b;}
+  static Vector Max(const Vector a, const Vector b) {return a > b ? a : b;}
+  static Mask Less(const Vector a, const Vector b) {return a < b;}
+  static Mask Greater(const Vector a, const Vector b) {return a > b;}
+  static Mask Equal(const Vector a, const Vector b) {return a == b;}
+  static Mask SignBit(const Vector value) {return std::signbit(value);}
+  static Vector Select(const Mask mask, const Vector if_true, const Vector if_false)
+  {
+    return mask ? if_true : if_false;
+  }
+  static Vector Pow2(const Vector exponent)
+  {
+    const auto bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(exponent) + 1023) << 52;
+    double result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+  }
+};
+
+void LibmSinCos(const double * angles, double * sines, double * cosines, std::size_t count)
+{
+  for (std::size_t i = 0; i < count; i++) {
+    sines[i] = sin(angles[i]);
+    cosines[i] = cos(angles[i]);
+  }
+}
+
+void LibmAtan2(const double * y, const double * x, double * angles, std::size_t count)
+{
+  for (std::size_t i = 0; i < count; i++) {
+    angles[i] = atan2(y[i], x[i]);
+  }
+}
+
+void LibmExp(const double * x, double * results, std::size_t count)
+{
+  for (std::size_t i = 0; i < count; i++) {
+    results[i] = exp(x[i]);
+  }
+}
+
+}  // namespace
+
+const MathKernels & GetLibmMathKernels()
+{
+  static const MathKernels kernels{"libm", LibmSinCos, LibmAtan2, LibmExp};
+  return kernels;
+}
+
+const MathKernels & GetScalarMathKernels()
+{
+  static const MathKernels kernels{
+    "scalar", fast_math::SinCosKernel<ScalarOps>, fast_math::Atan2Kernel<ScalarOps>,
+    fast_math::ExpKernel<ScalarOps>};
+  return kernels;
+}
+
+const MathKernels & GetFastMathKernels()
+{
+  static const MathKernels & kernels = []() -> const MathKernels & {
+#if defined(LOCALIZATION_FAST_MATH_AVX2)
+      if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return GetAvx2MathKernels();
+      }
+#endif
+#if defined(LOCALIZATION_FAST_MATH_NEON)
+      return GetNeonMathKernels();
+#endif
+      return GetScalarMathKernels();
+    }();
+  return kernels;
+}
+
+const MathKernels & GetMathKernels(const bool use_fast_math)
+{
+  return use_fast_math ? GetFastMathKernels() : GetLibmMathKernels();
+}
+
+}  // namespace localization
@@ -0,0 +1,60 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#ifndef FAST_MATH_HPP_
+#define FAST_MATH_HPP_
+
+#include <cstddef>
+
+namespace localization
+{
+
+// Batched math functions used by the filter's per-particle loops. Every set of kernels computes
+// the same functions, so callers pick a set once and call through it.
+//
+// The fast kernels are polynomial approximations. The largest errors against glibc's libm,
+// measured over a million random inputs per range, are:
+//   SinCos  |angle| <= 1e5                   absolute error < 3e-16
+//   Atan2   |x|, |y| from 1e-300 to 1e300    absolute error < 5e-16
+//   Exp     -708 <= x <= 709                 relative error < 4e-16
+// Larger angles lose accuracy as range reduction runs out of bits.
+// Exp returns 0 below -708 and exp(709) for finite x above 709. Otherwise NaN, infinite and
+// signed zero inputs give the same results as libm, apart from the sign of zero results.
+struct MathKernels
+{
+  // Name of the instruction set the kernels are built for, for logging
+  const char * name;
+  void (* sin_cos)(const double * angles, double * sines, double * cosines, std::size_t count);
+  void (* atan2)(const double * y, const double * x, double * angles, std::size_t count);
+  void (* exp)(const double * x, double * results, std::size_t count);
+};
+
+// Kernels that call libm for every element. The headers shared with the vector backends define
+// no inline functions, since copies built with vector instructions could replace the baseline ones.
+const MathKernels & GetLibmMathKernels();
+
+// Polynomial kernels for the widest vector instruction set this CPU supports (AVX2 and FMA on
+// x86-64, NEON on AArch64), falling back to scalar code
+const MathKernels & GetFastMathKernels();
+
+const MathKernels & GetMathKernels(const bool use_fast_math);
+
+}  // namespace localization
+
+#endif  // FAST_MATH_HPP_
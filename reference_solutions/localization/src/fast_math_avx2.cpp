@@ -0,0 +1,91 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Built with AVX2 and FMA enabled, and only called after GetFastMathKernels checks the CPU
+// supports them
+
+#include <immintrin.h>
+#include "fast_math_kernels.hpp"
+
+namespace localization
+{
+
+namespace
+{
+
+struct Avx2Ops
+{
+  using Vector = __m256d;
+  using Mask = __m256d;
+  static constexpr std::size_t kWidth = 4;
+
+  static Vector Load(const double * source) {return _mm256_loadu_pd(source);}
+  static void Store(double * destination, const Vector value)
+  {
+    _mm256_storeu_pd(destination, value);
+  }
+  static Vector Set(const double value) {return _mm256_set1_pd(value);}
+  static Vector Add(const Vector a, const Vector b) {return _mm256_add_pd(a, b);}
+  static Vector Sub(const Vector a, const Vector b) {return _mm256_sub_pd(a, b);}
+  static Vector Mul(const Vector a, const Vector b) {return _mm256_mul_pd(a, b);}
+  static Vector Div(const Vector a, const Vector b) {return _mm256_div_pd(a, b);}
+  static Vector Fma(const Vector a, const Vector b, const Vector c)
+  {
+    return _mm256_fmadd_pd(a, b, c);
+  }
+  static Vector Round(const Vector value)
+  {
+    return _mm256_round_pd(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static Vector Floor(const Vector value) {return _mm256_floor_pd(value);}
+  static Vector Abs(const Vector value)
+  {
+    return _mm256_andnot_pd(_mm256_set1_pd(-0.0), value);
+  }
+  static Vector Min(const Vector a, const Vector b) {return _mm256_min_pd(a, b);}
+  static Vector Max(const Vector a, const Vector b) {return _mm256_max_pd(a, b);}
+  static Mask Less(const Vector a, const Vector b) {return _mm256_cmp_pd(a, b, _CMP_LT_OQ);}
+  static Mask Greater(const Vector a, const Vector b) {return _mm256_cmp_pd(a, b, _CMP_GT_OQ);}
+  static Mask Equal(const Vector a, const Vector b) {return _mm256_cmp_pd(a, b, _CMP_EQ_OQ);}
+  // blendv only reads the sign bit of each mask lane
+  static Mask SignBit(const Vector value) {return value;}
+  static Vector Select(const Mask mask, const Vector if_true, const Vector if_false)
+  {
+    return _mm256_blendv_pd(if_false, if_true, mask);
+  }
+  static Vector Pow2(const Vector exponent)
+  {
+    const __m256i biased = _mm256_add_epi64(
+      _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(exponent)), _mm256_set1_epi64x(1023));
+    return _mm256_castsi256_pd(_mm256_slli_epi64(biased, 52));
+  }
+};
+
+}  // namespace
+
+const MathKernels & GetAvx2MathKernels()
+{
+  static const MathKernels kernels{
+    "avx2", fast_math::SinCosKernel<Avx2Ops>, fast_math::Atan2Kernel<Avx2Ops>,
+    fast_math::ExpKernel<Avx2Ops>};
+  return kernels;
+}
+
+}  // namespace localization
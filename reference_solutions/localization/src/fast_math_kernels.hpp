@@ -0,0 +1,259 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#ifndef FAST_MATH_KERNELS_HPP_
+#define FAST_MATH_KERNELS_HPP_
+
+#include <cstddef>
+#include <limits>
+#include "fast_math.hpp"
+
+// Polynomial kernels shared by every instruction set. Each backend's translation unit supplies
+// an Ops type with the vector operations below and instantiates the kernels with it. Ops types
+// live in unnamed namespaces, so code built for one instruction set never leaks into another.
+//
+// Ops provides Vector, Mask, kWidth, Load, Store, Set, Add, Sub, Mul, Div, Fma(a, b, c) for
+// a * b + c, Round (to nearest), Floor, Abs, Min, Max, Less, Greater, Equal, SignBit (set for
+// negative values including -0), Select(mask, if_true, if_false) and Pow2 (2 to the power of an
+// integral valued vector).
+
+namespace localization
+{
+
+const MathKernels & GetScalarMathKernels();
+#if defined(LOCALIZATION_FAST_MATH_AVX2)
+const MathKernels & GetAvx2MathKernels();
+#endif
+#if defined(LOCALIZATION_FAST_MATH_NEON)
+const MathKernels & GetNeonMathKernels();
+#endif
+
+namespace fast_math
+{
+
+// pi / 2 split into pieces whose products with the quadrant count are exact
+constexpr double kPiOver2High = 1.57079632673412561417e+00;
+constexpr double kPiOver2Middle = 6.07710050630396597660e-11;
+constexpr double kPiOver2Low = 2.02226624879595063154e-21;
+constexpr double kTwoOverPi = 6.36619772367581382433e-01;
+constexpr double kPi = 3.14159265358979311600e+00;
+constexpr double kPiOver2 = 1.57079632679489655800e+00;
+constexpr double kPiOver4 = 7.85398163397448278999e-01;
+// Part of pi / 4 below kPiOver4's precision
+constexpr double kPiOver4Low = 3.06161699786838301793e-17;
+constexpr double kLn2High = 6.93147180369123816490e-01;
+constexpr double kLn2Low = 1.90821492927058770002e-10;
+constexpr double kLog2E = 1.44269504088896338700e+00;
+constexpr double kExpMin = -708.0;
+constexpr double kExpMax = 709.0;
+constexpr double kMaxFinite = std::numeric_limits<double>::max();
+
+// Returns sin and cos of x. x is reduced by the nearest multiple of pi / 2 to [-pi / 4, pi / 4],
+// where Taylor series through degree 15 and 16 are accurate to well under an ulp.
+template<typename Ops>
+inline void SinCos(
+  const typename Ops::Vector x, typename Ops::Vector & sine,
+  typename Ops::Vector & cosine)
+{
+  const auto quadrant = Ops::Round(Ops::Mul(x, Ops::Set(kTwoOverPi)));
+  auto r = Ops::Fma(quadrant, Ops::Set(-kPiOver2High), x);
+  r = Ops::Fma(quadrant, Ops::Set(-kPiOver2Middle), r);
+  r = Ops::Fma(quadrant, Ops::Set(-kPiOver2Low), r);
+  const auto z = Ops::Mul(r, r);
+
+  auto sine_poly = Ops::Set(-1.0 / 1307674368000.0);
+  sine_poly = Ops::Fma(sine_poly, z, Ops::Set(1.0 / 6227020800.0));
+  sine_poly = Ops::Fma(sine_poly, z, Ops::Set(-1.0 / 39916800.0));
+  sine_poly = Ops::Fma(sine_poly, z, Ops::Set(1.0 / 362880.0));
+  sine_poly = Ops::Fma(sine_poly, z, Ops::Set(-1.0 / 5040.0));
+  sine_poly = Ops::Fma(sine_poly, z, Ops::Set(1.0 / 120.0));
+  sine_poly = Ops::Fma(sine_poly, z, Ops::Set(-1.0 / 6.0));
+  const auto reduced_sine = Ops::Fma(Ops::Mul(sine_poly, z), r, r);
+
+  auto cosine_poly = Ops::Set(1.0 / 20922789888000.0);
+  cosine_poly = Ops::Fma(cosine_poly, z, Ops::Set(-1.0 / 87178291200.0));
+  cosine_poly = Ops::Fma(cosine_poly, z, Ops::Set(1.0 / 479001600.0));
+  cosine_poly = Ops::Fma(cosine_poly, z, Ops::Set(-1.0 / 3628800.0));
+  cosine_poly = Ops::Fma(cosine_poly, z, Ops::Set(1.0 / 40320.0));
+  cosine_poly = Ops::Fma(cosine_poly, z, Ops::Set(-1.0 / 720.0));
+  cosine_poly = Ops::Fma(cosine_poly, z, Ops::Set(1.0 / 24.0));
+  cosine_poly = Ops::Fma(cosine_poly, z, Ops::Set(-0.5));
+  const auto reduced_cosine = Ops::Fma(cosine_poly, z, Ops::Set(1.0));
+
+  // Quadrant q in [0, 4) swaps sine and cosine when odd, negates sine when q >= 2 and negates
+  // cosine when q is 1 or 2
+  const auto q = Ops::Sub(
+    quadrant, Ops::Mul(Ops::Floor(Ops::Mul(quadrant, Ops::Set(0.25))), Ops::Set(4.0)));
+  const auto odd = Ops::Greater(
+    Ops::Sub(q, Ops::Mul(Ops::Floor(Ops::Mul(q, Ops::Set(0.5))), Ops::Set(2.0))),
+    Ops::Set(0.5));
+  const auto sine_negative = Ops::Greater(q, Ops::Set(1.5));
+  const auto cosine_negative = Ops::Less(
+    Ops::Abs(Ops::Sub(q, Ops::Set(1.5))), Ops::Set(1.0));
+  const auto unsigned_sine = Ops::Select(odd, reduced_cosine, reduced_sine);
+  const auto unsigned_cosine = Ops::Select(odd, reduced_sine, reduced_cosine);
+  const auto zero = Ops::Set(0.0);
+  sine = Ops::Select(sine_negative, Ops::Sub(zero, unsigned_sine), unsigned_sine);
+  cosine = Ops::Select(cosine_negative, Ops::Sub(zero, unsigned_cosine), unsigned_cosine);
+}
+
+// Returns atan2(y, x). The smaller of |x| and |y| over the larger is in [0, 1], which is reduced
+// to [-0.21, 0.66] around pi / 4 and approximated with Cephes' rational atan.
+template<typename Ops>
+inline typename Ops::Vector Atan2(const typename Ops::Vector y, const typename Ops::Vector x)
+{
+  const auto zero = Ops::Set(0.0);
+  const auto abs_x = Ops::Abs(x);
+  const auto abs_y = Ops::Abs(y);
+  const auto larger = Ops::Max(abs_x, abs_y);
+  const auto smaller = Ops::Min(abs_x, abs_y);
+  // Keeps atan2(0, 0) at 0 instead of dividing 0 by 0, and two infinities at a ratio of 1
+  auto ratio = Ops::Div(
+    smaller, Ops::Select(Ops::Greater(larger, zero), larger, Ops::Set(1.0)));
+  ratio = Ops::Select(Ops::Greater(smaller, Ops::Set(kMaxFinite)), Ops::Set(1.0), ratio);
+
+  const auto reduce = Ops::Greater(ratio, Ops::Set(0.66));
+  const auto t = Ops::Select(
+    reduce, Ops::Div(Ops::Sub(ratio, Ops::Set(1.0)), Ops::Add(ratio, Ops::Set(1.0))), ratio);
+  const auto z = Ops::Mul(t, t);
+  auto numerator = Ops::Set(-8.750608600031904122785e-01);
+  numerator = Ops::Fma(numerator, z, Ops::Set(-1.615753718733365076637e+01));
+  numerator = Ops::Fma(numerator, z, Ops::Set(-7.500855792314704667340e+01));
+  numerator = Ops::Fma(numerator, z, Ops::Set(-1.228866684490136173410e+02));
+  numerator = Ops::Fma(numerator, z, Ops::Set(-6.485021904942025371773e+01));
+  auto denominator = Ops::Add(z, Ops::Set(2.485846490142306297962e+01));
+  denominator = Ops::Fma(denominator, z, Ops::Set(1.650270098316988542046e+02));
+  denominator = Ops::Fma(denominator, z, Ops::Set(4.328810604912902668951e+02));
+  denominator = Ops::Fma(denominator, z, Ops::Set(4.853903996359136964868e+02));
+  denominator = Ops::Fma(denominator, z, Ops::Set(1.945506571482613964425e+02));
+  auto angle = Ops::Fma(Ops::Div(Ops::Mul(z, numerator), denominator), t, t);
+  angle = Ops::Add(angle, Ops::Select(reduce, Ops::Set(kPiOver4Low), zero));
+  angle = Ops::Add(angle, Ops::Select(reduce, Ops::Set(kPiOver4), zero));
+
+  angle = Ops::Select(Ops::Greater(abs_y, abs_x), Ops::Sub(Ops::Set(kPiOver2), angle), angle);
+  // Sign bits rather than comparisons, so -0 picks the same half plane as in libm
+  angle = Ops::Select(Ops::SignBit(x), Ops::Sub(Ops::Set(kPi), angle), angle);
+  angle = Ops::Select(Ops::SignBit(y), Ops::Sub(zero, angle), angle);
+  angle = Ops::Select(Ops::Equal(x, x), angle, x);
+  return Ops::Select(Ops::Equal(y, y), angle, y);
+}
+
+// Returns exp(x) as 2^k * exp(r) with |r| <= ln(2) / 2, where a degree 12 Taylor series is
+// accurate to well under an ulp
+template<typename Ops>
+inline typename Ops::Vector Exp(const typename Ops::Vector x)
+{
+  const auto clamped = Ops::Min(Ops::Max(x, Ops::Set(kExpMin)), Ops::Set(kExpMax));
+  const auto k = Ops::Round(Ops::Mul(clamped, Ops::Set(kLog2E)));
+  auto r = Ops::Fma(k, Ops::Set(-kLn2High), clamped);
+  r = Ops::Fma(k, Ops::Set(-kLn2Low), r);
+
+  auto poly = Ops::Set(1.0 / 479001600.0);
+  poly = Ops::Fma(poly, r, Ops::Set(1.0 / 39916800.0));
+  poly = Ops::Fma(poly, r, Ops::Set(1.0 / 3628800.0));
+  poly = Ops::Fma(poly, r, Ops::Set(1.0 / 362880.0));
+  poly = Ops::Fma(poly, r, Ops::Set(1.0 / 40320.0));
+  poly = Ops::Fma(poly, r, Ops::Set(1.0 / 5040.0));
+  poly = Ops::Fma(poly, r, Ops::Set(1.0 / 720.0));
+  poly = Ops::Fma(poly, r, Ops::Set(1.0 / 120.0));
+  poly = Ops::Fma(poly, r, Ops::Set(1.0 / 24.0));
+  poly = Ops::Fma(poly, r, Ops::Set(1.0 / 6.0));
+  poly = Ops::Fma(poly, r, Ops::Set(0.5));
+  poly = Ops::Fma(poly, r, Ops::Set(1.0));
+  poly = Ops::Fma(poly, r, Ops::Set(1.0));
+
+  auto result = Ops::Mul(poly, Ops::Pow2(k));
+  result = Ops::Select(Ops::Less(x, Ops::Set(kExpMin)), Ops::Set(0.0), result);
+  // The clamp above maps NaN and +inf to finite values, so both are passed through here
+  result = Ops::Select(Ops::Greater(x, Ops::Set(kMaxFinite)), x, result);
+  return Ops::Select(Ops::Equal(x, x), result, x);
+}
+
+// Applies function to whole vectors of inputs, padding the last partial vector with zeros
+template<typename Ops, std::size_t kInputs, std::size_t kOutputs, typename Function>
+inline void ForEachVector(
+  const double * const (&inputs)[kInputs], double * const (&outputs)[kOutputs],
+  const std::size_t count, Function function)
+{
+  typename Ops::Vector in[kInputs];
+  typename Ops::Vector out[kOutputs];
+  std::size_t i = 0;
+  for (; i + Ops::kWidth <= count; i += Ops::kWidth) {
+    for (std::size_t input = 0; input < kInputs; input++) {
+      in[input] = Ops::Load(inputs[input] + i);
+    }
+    function(in, out);
+    for (std::size_t output = 0; output < kOutputs; output++) {
+      Ops::Store(outputs[output] + i, out[output]);
+    }
+  }
+  if (i == count) {
+    return;
+  }
+  double buffer[kInputs > kOutputs ? kInputs : kOutputs][Ops::kWidth] = {};
+  const std::size_t remaining = count - i;
+  for (std::size_t input = 0; input < kInputs; input++) {
+    for (std::size_t lane = 0; lane < remaining; lane++) {
+      buffer[input][lane] = inputs[input][i + lane];
+    }
+    in[input] = Ops::Load(buffer[input]);
+  }
+  function(in, out);
+  for (std::size_t output = 0; output < kOutputs; output++) {
+    Ops::Store(buffer[output], out[output]);
+    for (std::size_t lane = 0; lane < remaining; lane++) {
+      outputs[output][i + lane] = buffer[output][lane];
+    }
+  }
+}
+
+template<typename Ops>
+void SinCosKernel(const double * angles, double * sines, double * cosines, std::size_t count)
+{
+  ForEachVector<Ops>(
+    {angles}, {sines, cosines}, count,
+    [](const typename Ops::Vector (&in)[1], typename Ops::Vector (&out)[2]) {
+      SinCos<Ops>(in[0], out[0], out[1]);
+    });
+}
+
+template<typename Ops>
+void Atan2Kernel(const double * y, const double * x, double * angles, std::size_t count)
+{
+  ForEachVector<Ops>(
+    {y, x}, {angles}, count,
+    [](const typename Ops::Vector (&in)[2], typename Ops::Vector (&out)[1]) {
+      out[0] = Atan2<Ops>(in[0], in[1]);
+    });
+}
+
+template<typename Ops>
+void ExpKernel(const double * x, double * results, std::size_t count)
+{
+  ForEachVector<Ops>(
+    {x}, {results}, count,
+    [](const typename Ops::Vector (&in)[1], typename Ops::Vector (&out)[1]) {
+      out[0] = Exp<Ops>(in[0]);
+    });
+}
+
+}  // namespace fast_math
+}  // namespace localization
+
+#endif  // FAST_MATH_KERNELS_HPP_
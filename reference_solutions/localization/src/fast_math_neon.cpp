@@ -0,0 +1,79 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// NEON is part of the AArch64 baseline, so this needs no extra compiler flags or CPU check
+
+#include <arm_neon.h>
+#include "fast_math_kernels.hpp"
+
+namespace localization
+{
+
+namespace
+{
+
+struct NeonOps
+{
+  using Vector = float64x2_t;
+  using Mask = uint64x2_t;
+  static constexpr std::size_t kWidth = 2;
+
+  static Vector Load(const double * source) {return vld1q_f64(source);}
+  static void Store(double * destination, const Vector value) {vst1q_f64(destination, value);}
+  static Vector Set(const double value) {return vdupq_n_f64(value);}
+  static Vector Add(const Vector a, const Vector b) {return vaddq_f64(a, b);}
+  static Vector Sub(const Vector a, const Vector b) {return vsubq_f64(a, b);}
+  static Vector Mul(const Vector a, const Vector b) {return vmulq_f64(a, b);}
+  static Vector Div(const Vector a, const Vector b) {return vdivq_f64(a, b);}
+  static Vector Fma(const Vector a, const Vector b, const Vector c) {return vfmaq_f64(c, a, b);}
+  static Vector Round(const Vector value) {return vrndnq_f64(value);}
+  static Vector Floor(const Vector value) {return vrndmq_f64(value);}
+  static Vector Abs(const Vector value) {return vabsq_f64(value);}
+  static Vector Min(const Vector a, const Vector b) {return vminq_f64(a, b);}
+  static Vector Max(const Vector a, const Vector b) {return vmaxq_f64(a, b);}
+  static Mask Less(const Vector a, const Vector b) {return vcltq_f64(a, b);}
+  static Mask Greater(const Vector a, const Vector b) {return vcgtq_f64(a, b);}
+  static Mask Equal(const Vector a, const Vector b) {return vceqq_f64(a, b);}
+  static Mask SignBit(const Vector value)
+  {
+    return vcltzq_s64(vreinterpretq_s64_f64(value));
+  }
+  static Vector Select(const Mask mask, const Vector if_true, const Vector if_false)
+  {
+    return vbslq_f64(mask, if_true, if_false);
+  }
+  static Vector Pow2(const Vector exponent)
+  {
+    const int64x2_t biased = vaddq_s64(vcvtq_s64_f64(exponent), vdupq_n_s64(1023));
+    return vreinterpretq_f64_s64(vshlq_n_s64(biased, 52));
+  }
+};
+
+}  // namespace
+
+const MathKernels & GetNeonMathKernels()
+{
+  static const MathKernels kernels{
+    "neon", fast_math::SinCosKernel<NeonOps>, fast_math::Atan2Kernel<NeonOps>,
+    fast_math::ExpKernel<NeonOps>};
+  return kernels;
+}
+
+}  // namespace localization
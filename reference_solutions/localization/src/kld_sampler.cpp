@@ -0,0 +1,84 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "kld_sampler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+namespace localization
+{
+
+KldSampler::KldSampler(rclcpp::Node & node)
+{
+  enabled_ = node.declare_parameter<bool>("kld_sampling.enabled", false);
+  const auto min_particles = node.declare_parameter<int>("kld_sampling.min_particles", 100);
+  const auto max_particles = node.declare_parameter<int>("kld_sampling.max_particles", 5000);
+  max_error_ = node.declare_parameter<double>("kld_sampling.max_error", 0.05);
+  // Standard normal quantile of the confidence the error bound holds with (2.33 is 99%)
+  upper_quantile_ = node.declare_parameter<double>("kld_sampling.upper_quantile", 2.33);
+  xy_bin_size_ = node.declare_parameter<double>("kld_sampling.xy_bin_size", 0.05);
+  yaw_bin_size_ = node.declare_parameter<double>("kld_sampling.yaw_bin_size", 0.17);
+  if (min_particles <= 0 || max_particles <= 0) {
+    throw std::runtime_error{"kld_sampling.min_particles and max_particles must be positive."};
+  }
+  if (!(max_error_ > 0) || !(xy_bin_size_ > 0) || !(yaw_bin_size_ > 0)) {
+    throw std::runtime_error{"kld_sampling.max_error and the bin sizes must be positive."};
+  }
+  min_particles_ = min_particles;
+  max_particles_ = std::max(max_particles, min_particles);
+}
+
+std::size_t KldSampler::GetParticleCount(const ParticleSet & particles)
+{
+  // 21 bits per axis is far more bins than any map needs, so masking never merges nearby bins
+  constexpr std::uint64_t kAxisMask = (1u << 21) - 1;
+  const auto to_bin = [](const double value, const double bin_size) {
+      return static_cast<std::uint64_t>(static_cast<std::int64_t>(std::floor(value / bin_size))) &
+             kAxisMask;
+    };
+  bins_.clear();
+  for (std::size_t i = 0; i < particles.size(); i++) {
+    if (particles.weight[i] > 0) {
+      bins_.push_back(
+        (to_bin(particles.x[i], xy_bin_size_) << 42) |
+        (to_bin(particles.y[i], xy_bin_size_) << 21) |
+        to_bin(particles.yaw[i] + M_PI, yaw_bin_size_));
+    }
+  }
+  std::sort(bins_.begin(), bins_.end());
+  occupied_bins_ = std::unique(bins_.begin(), bins_.end()) - bins_.begin();
+  if (occupied_bins_ <= 1) {
+    return min_particles_;
+  }
+
+  // Wilson-Hilferty approximation of the chi-square quantile with occupied_bins_ - 1 degrees of
+  // freedom
+  const double degrees_of_freedom = occupied_bins_ - 1.0;
+  const double a = 2.0 / (9.0 * degrees_of_freedom);
+  const double cube_root = 1.0 - a + std::sqrt(a) * upper_quantile_;
+  const double count = degrees_of_freedom / (2.0 * max_error_) * cube_root * cube_root * cube_root;
+  return std::clamp(
+    static_cast<std::size_t>(std::min(std::ceil(count), static_cast<double>(max_particles_))),
+    min_particles_, max_particles_);
+}
+
+}  // namespace localization
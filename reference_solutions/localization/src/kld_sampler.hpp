@@ -0,0 +1,75 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#ifndef KLD_SAMPLER_HPP_
+#define KLD_SAMPLER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <rclcpp/rclcpp.hpp>
+#include "particle_set.hpp"
+
+namespace localization
+{
+
+// Picks how many particles to resample from how spread out the current particle set is, using the
+// KLD-sampling bound: enough particles that, with the configured confidence, the sampled
+// distribution is within the configured KL divergence of the true one over a histogram of poses.
+class KldSampler
+{
+public:
+  explicit KldSampler(rclcpp::Node & node);
+
+  bool IsEnabled() const
+  {
+    return enabled_;
+  }
+
+  std::size_t GetMaxParticles() const
+  {
+    return max_particles_;
+  }
+
+  // Counts the histogram bins holding a particle with nonzero weight and returns the particle count
+  // they call for, within the configured bounds
+  std::size_t GetParticleCount(const ParticleSet & particles);
+
+  // Occupied bins found by the last call to GetParticleCount
+  std::size_t GetOccupiedBinCount() const
+  {
+    return occupied_bins_;
+  }
+
+private:
+  bool enabled_;
+  std::size_t min_particles_;
+  std::size_t max_particles_;
+  double max_error_;
+  double upper_quantile_;
+  double xy_bin_size_;
+  double yaw_bin_size_;
+  std::size_t occupied_bins_ = 0;
+  // Packed bin of every weighted particle, kept between calls so counting doesn't allocate
+  std::vector<std::uint64_t> bins_;
+};
+
+}  // namespace localization
+
+#endif  // KLD_SAMPLER_HPP_
@@ -19,7 +19,7 @@
 // THE SOFTWARE.
 
 #include "motion_model.hpp"
-#include <angles/angles.h>
+#include <cmath>
 #include <memory>
 #include <vector>
 
@@ -27,7 +27,8 @@ namespace localization
 {
 
 
-MotionModel::MotionModel(rclcpp::Node & node)
+MotionModel::MotionModel(rclcpp::Node & node, const MathKernels & math)
+: math_(math)
 {
   std::vector<double> motion_sigma = node.declare_parameter<std::vector<double>>(
     "motion_sigmas",
@@ -40,28 +41,11 @@ MotionModel::MotionModel(rclcpp::Node & node)
   sigmas_.yaw_vel = motion_sigma[4];
 }
 
-void MotionModel::updateParticle(
-  Particle & particle, double dt,
-  geometry_msgs::msg::Twist::SharedPtr cmd_msg)
-{
-  particle.x += cos(particle.yaw) * particle.x_vel * dt + sigmas_.x * gaussian_noise_.Sample() *
-    sqrt(
-    dt);
-  particle.y += -sin(particle.yaw) * particle.x_vel * dt + sigmas_.y * gaussian_noise_.Sample() *
-    sqrt(
-    dt);
-  particle.yaw += particle.yaw_vel * dt + sigmas_.yaw * gaussian_noise_.Sample() * sqrt(dt);
-
-  particle.x_vel = cmd_msg->linear.x + sigmas_.x_vel * gaussian_noise_.Sample() * sqrt(dt);
-  particle.yaw_vel = -cmd_msg->angular.z + sigmas_.yaw_vel * gaussian_noise_.Sample() * sqrt(dt);
-
-  particle.yaw = angles::normalize_angle(particle.yaw);
-}
-
 void MotionModel::updateParticles(
-  std::vector<Particle> & particles,
+  ParticleSet & particles,
   geometry_msgs::msg::Twist::SharedPtr cmd_msg,
-  rclcpp::Time current_time)
+  rclcpp::Time current_time,
+  WorkerPool & workers)
 {
   double dt = current_time.seconds() - last_message_time_.seconds();
   if (dt > 1.0) {
@@ -69,10 +53,57 @@ void MotionModel::updateParticles(
     // very small motion can help with convergence
     dt = 0.01;
   }
-  for (Particle & particle : particles) {
-    updateParticle(particle, dt, cmd_msg);
-  }
   last_message_time_ = current_time;
+
+  const std::size_t count = particles.size();
+  // Drawing each worker's noise up front keeps the random engine out of the update loop
+  noise_.resize(5 * count);
+  sin_yaw_.resize(count);
+  cos_yaw_.resize(count);
+  while (noise_streams_.size() < static_cast<std::size_t>(workers.GetThreadCount())) {
+    noise_streams_.emplace_back(static_cast<unsigned int>(noise_streams_.size()));
+  }
+  const double * x_noise = noise_.data();
+  const double * y_noise = x_noise + count;
+  const double * yaw_noise = y_noise + count;
+  const double * x_vel_noise = yaw_noise + count;
+  const double * yaw_vel_noise = x_vel_noise + count;
+
+  const double sqrt_dt = sqrt(dt);
+  const double x_sigma = sigmas_.x * sqrt_dt;
+  const double y_sigma = sigmas_.y * sqrt_dt;
+  const double yaw_sigma = sigmas_.yaw * sqrt_dt;
+  const double x_vel_sigma = sigmas_.x_vel * sqrt_dt;
+  const double yaw_vel_sigma = sigmas_.yaw_vel * sqrt_dt;
+  const double commanded_x_vel = cmd_msg->linear.x;
+  const double commanded_yaw_vel = -cmd_msg->angular.z;
+
+  double * x = particles.x.data();
+  double * y = particles.y.data();
+  double * yaw = particles.yaw.data();
+  double * x_vel = particles.x_vel.data();
+  double * yaw_vel = particles.yaw_vel.data();
+  workers.RunChunked(
+    count, [&](const std::size_t begin, const std::size_t end, const int worker_index) {
+      auto & noise_stream = noise_streams_[worker_index];
+      for (std::size_t block = 0; block < 5; ++block) {
+        double * samples = noise_.data() + block * count;
+        for (std::size_t i = begin; i < end; ++i) {
+          samples[i] = noise_stream.Sample();
+        }
+      }
+      math_.sin_cos(yaw + begin, sin_yaw_.data() + begin, cos_yaw_.data() + begin, end - begin);
+      const double * sin_yaw = sin_yaw_.data();
+      const double * cos_yaw = cos_yaw_.data();
+      for (std::size_t i = begin; i < end; ++i) {
+        x[i] += cos_yaw[i] * x_vel[i] * dt + x_sigma * x_noise[i];
+        y[i] += -sin_yaw[i] * x_vel[i] * dt + y_sigma * y_noise[i];
+        yaw[i] = WrapAngle(yaw[i] + yaw_vel[i] * dt + yaw_sigma * yaw_noise[i]);
+
+        x_vel[i] = commanded_x_vel + x_vel_sigma * x_vel_noise[i];
+        yaw_vel[i] = commanded_yaw_vel + yaw_vel_sigma * yaw_vel_noise[i];
+      }
+    });
 }
 
 bool MotionModel::getEnabled(const rclcpp::Time & current_time)
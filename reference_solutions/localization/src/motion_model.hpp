@@ -26,8 +26,11 @@
 #include <vector>
 #include <geometry_msgs/msg/twist.hpp>
 #include <rclcpp/rclcpp.hpp>
+#include "fast_math.hpp"
 #include "particle.hpp"
+#include "particle_set.hpp"
 #include "random_helpers.hpp"
+#include "worker_pool.hpp"
 
 namespace localization
 {
@@ -35,19 +38,26 @@ namespace localization
 class MotionModel
 {
 public:
-  explicit MotionModel(rclcpp::Node & node);
+  MotionModel(rclcpp::Node & node, const MathKernels & math);
 
-  void updateParticle(Particle & particle, double dt, geometry_msgs::msg::Twist::SharedPtr cmd_msg);
   void updateParticles(
-    std::vector<Particle> & particles,
+    ParticleSet & particles,
     geometry_msgs::msg::Twist::SharedPtr cmd_msg,
-    rclcpp::Time current_time);
+    rclcpp::Time current_time,
+    WorkerPool & workers);
   bool getEnabled(const rclcpp::Time & time);
 
 private:
+  const MathKernels & math_;
   Particle sigmas_;
   rclcpp::Time last_message_time_;
-  GaussianRandomGenerator gaussian_noise_;
+  // One noise stream per worker, so each worker's share of particles sees the same samples on
+  // every run with the same thread count
+  std::vector<GaussianRandomGenerator> noise_streams_;
+  // Standard normal samples for one update, one block of particle count samples per state field
+  AlignedVector<double> noise_;
+  AlignedVector<double> sin_yaw_;
+  AlignedVector<double> cos_yaw_;
 };
 
 }  // namespace localization
@@ -38,20 +38,31 @@ OdometrySensorModel::OdometrySensorModel(rclcpp::Node & node)
 void OdometrySensorModel::UpdateMeasurement(const nav_msgs::msg::Odometry::SharedPtr msg)
 {
   last_msg_ = *msg;
+  measurement_sequence_++;
 }
 
-double OdometrySensorModel::ComputeLogNormalizer()
+double OdometrySensorModel::ComputeLogNormalizer() const
 {
   return log(sqrt(pow(2 * M_PI, 2))) +
          log(sqrt(covariance_[0])) + log(sqrt(covariance_[1]));
 }
 
-double OdometrySensorModel::ComputeLogProb(const Particle & particle)
+void OdometrySensorModel::AccumulateLogWeights(
+  const ParticleSpan & particles,
+  double * log_weights) const
 {
-  double log_prob = 0.0;
-  log_prob += pow(last_msg_.twist.twist.linear.x - particle.x_vel, 2) / covariance_[0];
-  log_prob += pow(last_msg_.twist.twist.angular.z - particle.yaw_vel, 2) / covariance_[1];
-  return log_prob;
+  const double x_vel = last_msg_.twist.twist.linear.x;
+  const double yaw_vel = last_msg_.twist.twist.angular.z;
+  const double x_vel_information = 1.0 / covariance_[0];
+  const double yaw_vel_information = 1.0 / covariance_[1];
+  const double log_normalizer = ComputeLogNormalizer();
+  for (std::size_t i = 0; i < particles.size; i++) {
+    const double x_vel_error = x_vel - particles.x_vel[i];
+    const double yaw_vel_error = yaw_vel - particles.yaw_vel[i];
+    const double squared_error = x_vel_error * x_vel_error * x_vel_information +
+      yaw_vel_error * yaw_vel_error * yaw_vel_information;
+    log_weights[i] += -0.5 * squared_error - log_normalizer;
+  }
 }
 
 bool OdometrySensorModel::IsMeasurementAvailable(const rclcpp::Time & current_time)
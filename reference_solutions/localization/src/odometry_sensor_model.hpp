@@ -33,8 +33,8 @@ public:
   explicit OdometrySensorModel(rclcpp::Node & node);
 
   void UpdateMeasurement(const nav_msgs::msg::Odometry::SharedPtr msg);
-  double ComputeLogProb(const Particle & particle) override;
-  double ComputeLogNormalizer() override;
+  void AccumulateLogWeights(const ParticleSpan & particles, double * log_weights) const override;
+  double ComputeLogNormalizer() const override;
   bool IsMeasurementAvailable(const rclcpp::Time & cur_time) override;
 
 private:
@@ -19,9 +19,9 @@
 // THE SOFTWARE.
 
 #include "particle_filter_localizer.hpp"
-#include <angles/angles.h>
 #include <algorithm>
 #include <memory>
+#include <string>
 #include <vector>
 #include <utility>
 #include <rclcpp_components/register_node_macro.hpp>
@@ -38,14 +38,24 @@ using namespace std::chrono_literals;
 ParticleFilterLocalizer::ParticleFilterLocalizer(const rclcpp::NodeOptions & options)
 : rclcpp::Node("particle_filter_localizer", options),
   tf_buffer_(get_clock()), tf_listener_(tf_buffer_), tf_broadcaster_(this),
-  motion_model_(*this)
+  workers_(declare_parameter<int>("num_threads", 1)),
+  math_(GetMathKernels(declare_parameter<bool>("use_fast_math", false))),
+  motion_model_(*this, math_),
+  kld_sampler_(*this)
 {
   cmd_sub_ = create_subscription<geometry_msgs::msg::Twist>(
     "/cmd_vel", 10, std::bind(&ParticleFilterLocalizer::CmdCallback, this, std::placeholders::_1));
   odom_pub_ = create_publisher<nav_msgs::msg::Odometry>("~/pose_estimate", 1);
   marker_pub_ = create_publisher<visualization_msgs::msg::Marker>("~/particles", 1);
+  diagnostics_pub_ = create_publisher<diagnostic_msgs::msg::DiagnosticArray>("/diagnostics", 1);
+
+  RCLCPP_INFO(get_logger(), "Using %s math kernels", math_.name);
 
   num_particles_ = declare_parameter<int>("num_particles", 300);
+  if (kld_sampler_.IsEnabled()) {
+    // The initial distribution is as uncertain as the filter gets
+    num_particles_ = kld_sampler_.GetMaxParticles();
+  }
   declare_parameter<double>("resample_threshold", 0.1);
   declare_parameter<double>("low_percentage_particles_to_drop", 0.1);
 
@@ -54,6 +64,10 @@ ParticleFilterLocalizer::ParticleFilterLocalizer(const rclcpp::NodeOptions & opt
   initial_range_.min_y = declare_parameter<double>("initial_range.min_y", -0.3);
   initial_range_.max_y = declare_parameter<double>("initial_range.max_y", 0.3);
 
+  for (int worker_index = 0; worker_index < workers_.GetThreadCount(); ++worker_index) {
+    resample_streams_.emplace_back(static_cast<unsigned int>(worker_index));
+  }
+
   InitializeParticles();
 
   const double state_update_rate = declare_parameter<double>("state_update_rate", 10);
@@ -62,12 +76,23 @@ ParticleFilterLocalizer::ParticleFilterLocalizer(const rclcpp::NodeOptions & opt
     std::bind(&ParticleFilterLocalizer::CalculateStateAndPublish, this));
 
   resample_rate_ = declare_parameter<double>("resample_rate", 10);
+  const auto resample_strategy =
+    declare_parameter<std::string>("resample_strategy", "systematic");
+  if (resample_strategy == "stratified") {
+    resample_strategy_ = ResampleStrategy::Stratified;
+  } else if (resample_strategy == "residual") {
+    resample_strategy_ = ResampleStrategy::Residual;
+  } else if (resample_strategy != "systematic") {
+    RCLCPP_WARN(
+      get_logger(), "Unknown resample_strategy '%s', using systematic resampling",
+      resample_strategy.c_str());
+  }
   // ensure we poll for resample at higher than nyquist frequency
   resample_timer_ = create_wall_timer(
     std::chrono::duration<double>(1.0 / (resample_rate_ * 2 + 1)),
     std::bind(&ParticleFilterLocalizer::ResampleParticles, this));
 
-  sensor_models_.push_back(std::make_unique<ArucoSensorModel>(*this));
+  sensor_models_.push_back(std::make_unique<ArucoSensorModel>(*this, math_));
   // BEGIN STUDENT CODE
   sensor_models_.push_back(std::make_unique<OdometrySensorModel>(*this));
   // END STUDENT CODE
@@ -75,15 +100,17 @@ ParticleFilterLocalizer::ParticleFilterLocalizer(const rclcpp::NodeOptions & opt
 
 void ParticleFilterLocalizer::CmdCallback(const geometry_msgs::msg::Twist::SharedPtr msg)
 {
-  motion_model_.updateParticles(particles_, msg, now());
+  motion_model_.updateParticles(particles_, msg, now(), workers_);
+  particles_revision_++;
 }
 
 void ParticleFilterLocalizer::InitializeParticles()
 {
   particles_.resize(num_particles_);
-  std::generate(
-    particles_.begin(), particles_.end(),
-    std::bind(&ParticleFilterLocalizer::GenerateNewParticle, this));
+  for (int i = 0; i < num_particles_; i++) {
+    particles_.Set(i, GenerateNewParticle());
+  }
+  particles_revision_++;
   NormalizeWeights();
 }
 
@@ -108,18 +135,19 @@ void ParticleFilterLocalizer::NormalizeWeights()
   auto index_to_drop = std::round(
     get_parameter(
       "low_percentage_particles_to_drop").as_double() * num_particles_);
+  sorted_weights_.assign(particles_.weight.begin(), particles_.weight.end());
   std::nth_element(
-    particles_.begin(), particles_.begin() + index_to_drop, particles_.end(),
-    [](const Particle & lhs, const Particle & rhs) {return lhs.weight < rhs.weight;});
+    sorted_weights_.begin(), sorted_weights_.begin() + index_to_drop, sorted_weights_.end());
 
-  double smallest_weight_to_allow = particles_.at(index_to_drop).weight;
+  double smallest_weight_to_allow = sorted_weights_.at(index_to_drop);
 
+  double * weights = particles_.weight.data();
   double normalizer = 0;
-  for (Particle & particle : particles_) {
-    if (particle.weight < smallest_weight_to_allow) {
-      particle.weight = 0;
+  for (int i = 0; i < num_particles_; i++) {
+    if (weights[i] < smallest_weight_to_allow) {
+      weights[i] = 0;
     }
-    normalizer += particle.weight;
+    normalizer += weights[i];
   }
   // if all particles are zero
   double resample_threshold = get_parameter("resample_threshold").as_double();
@@ -127,9 +155,15 @@ void ParticleFilterLocalizer::NormalizeWeights()
     RCLCPP_INFO(
       get_logger(), "resampling particles from initial distribution since normalizer is low %f\n",
       normalizer / num_particles_);
-    std::generate_n(
-      particles_.begin(), num_particles_,
-      std::bind(&ParticleFilterLocalizer::GenerateNewParticle, this));
+    if (kld_sampler_.IsEnabled()) {
+      num_particles_ = kld_sampler_.GetMaxParticles();
+      particles_.resize(num_particles_);
+      weights = particles_.weight.data();
+    }
+    for (int i = 0; i < num_particles_; i++) {
+      particles_.Set(i, GenerateNewParticle());
+    }
+    particles_revision_++;
     normalizer = num_particles_;
   }
   if (normalizer == 0) {
@@ -140,35 +174,48 @@ void ParticleFilterLocalizer::NormalizeWeights()
   double running_sum = 0;
   min_weight_ = 1.0;
   max_weight_ = 0.0;
-  for (Particle & particle : particles_) {
-    if (particle.weight > 0) {
-      particle.weight /= normalizer;
+  for (int i = 0; i < num_particles_; i++) {
+    if (weights[i] > 0) {
+      weights[i] /= normalizer;
     }
-    min_weight_ = std::min(min_weight_, particle.weight);
-    max_weight_ = std::max(max_weight_, particle.weight);
+    min_weight_ = std::min(min_weight_, weights[i]);
+    max_weight_ = std::max(max_weight_, weights[i]);
+    running_sum += weights[i];
     search_weights_.push_back(running_sum);
-    running_sum += particle.weight;
   }
 }
 
 Particle ParticleFilterLocalizer::CalculateEstimate()
 {
+  const std::size_t count = particles_.size();
+  const double * x = particles_.x.data();
+  const double * y = particles_.y.data();
+  const double * yaw = particles_.yaw.data();
+  const double * x_vel = particles_.x_vel.data();
+  const double * yaw_vel = particles_.yaw_vel.data();
+  const double * weight = particles_.weight.data();
+  sin_yaw_.resize(count);
+  cos_yaw_.resize(count);
+  math_.sin_cos(yaw, sin_yaw_.data(), cos_yaw_.data(), count);
+
   Particle estimate;
+  estimate.x = 0.0;
+  estimate.y = 0.0;
+  estimate.x_vel = 0.0;
+  estimate.yaw_vel = 0.0;
   estimate.weight = 0.0;
-  estimate = std::accumulate(
-    particles_.begin(), particles_.end(), Particle{}, [](const auto & total, const auto & p) {
-      return total + p.Weighted();
-    });
-
   // handles averaging over the discontinuity
-  double yaw_x = std::accumulate(
-    particles_.begin(), particles_.end(), 0.0, [](const auto & total, const auto & p) {
-      return total + cos(p.yaw) * p.weight;
-    });
-  double yaw_y = std::accumulate(
-    particles_.begin(), particles_.end(), 0.0, [](const auto & total, const auto & p) {
-      return total + sin(p.yaw) * p.weight;
-    });
+  double yaw_x = 0.0;
+  double yaw_y = 0.0;
+  for (std::size_t i = 0; i < count; i++) {
+    estimate.x += x[i] * weight[i];
+    estimate.y += y[i] * weight[i];
+    estimate.x_vel += x_vel[i] * weight[i];
+    estimate.yaw_vel += yaw_vel[i] * weight[i];
+    estimate.weight += weight[i];
+    yaw_x += cos_yaw_[i] * weight[i];
+    yaw_y += sin_yaw_[i] * weight[i];
+  }
   estimate.yaw = atan2(yaw_y, yaw_x);
 
   return estimate;
@@ -177,17 +224,30 @@ Particle ParticleFilterLocalizer::CalculateEstimate()
 
 Particle ParticleFilterLocalizer::CalculateCovariance(const Particle & estimate)
 {
+  const std::size_t count = particles_.size();
+  const double * x = particles_.x.data();
+  const double * y = particles_.y.data();
+  const double * yaw = particles_.yaw.data();
+  const double * x_vel = particles_.x_vel.data();
+  const double * yaw_vel = particles_.yaw_vel.data();
+  const double * weight = particles_.weight.data();
+
   Particle cov;
   double cov_normalizer = 0;
-  for (const Particle & particle : particles_) {
-    cov.x += pow(estimate.x - particle.x, 2) * particle.weight;
-    cov.y += pow(estimate.y - particle.y, 2) * particle.weight;
-    cov.yaw +=
-      pow(angles::shortest_angular_distance(particle.yaw, estimate.yaw), 2) * particle.weight;
-    cov.x_vel += pow(estimate.x_vel - particle.x_vel, 2) * particle.weight;
-    cov.yaw_vel += pow(estimate.yaw_vel - particle.yaw_vel, 2) * particle.weight;
-
-    cov_normalizer += pow(particle.weight, 2);
+  for (std::size_t i = 0; i < count; i++) {
+    const double x_error = estimate.x - x[i];
+    const double y_error = estimate.y - y[i];
+    const double yaw_error = WrapAngle(estimate.yaw - yaw[i]);
+    const double x_vel_error = estimate.x_vel - x_vel[i];
+    const double yaw_vel_error = estimate.yaw_vel - yaw_vel[i];
+
+    cov.x += x_error * x_error * weight[i];
+    cov.y += y_error * y_error * weight[i];
+    cov.yaw += yaw_error * yaw_error * weight[i];
+    cov.x_vel += x_vel_error * x_vel_error * weight[i];
+    cov.yaw_vel += yaw_vel_error * yaw_vel_error * weight[i];
+
+    cov_normalizer += weight[i] * weight[i];
   }
 
   cov.x /= (1 - cov_normalizer);
@@ -220,62 +280,62 @@ void ParticleFilterLocalizer::ResampleParticles()
   }
   last_resample_time_ = current_time;
   CalculateAllParticleWeights(current_time);
-  // resample particles uniformly across the entire state space
-  std::vector<Particle> new_particles;
-  for (int i = 0; i < num_particles_; i++) {
-    // get a target values 0-1
-    double target_val = uniform_noise_.Sample();
-    int left_idx = 0;
-    int right_idx = num_particles_ - 1;
-    int cur_index = (left_idx + right_idx) / 2;
-
-    bool found_sol = false;
-    // binary search the summed weights to find the particle
-    while (left_idx <= right_idx && !found_sol) {
-      cur_index = (left_idx + right_idx) / 2;
-      double cur_val = search_weights_[cur_index];
-
-      if (cur_index == num_particles_ - 1 || cur_index == 0) {
-        found_sol = true;
-      } else if (target_val >= search_weights_[cur_index - 1] && target_val <= cur_val) {
-        // if we have found our target, return it
-        found_sol = true;
-      } else if (cur_val < target_val) {
-        // if we have a current smaller than target search to the right
-        left_idx = cur_index + 1;
-      } else if (cur_val > target_val) {
-        // if we have a current smaller than target search to the left
-        right_idx = cur_index - 1;
-      } else {
-        RCLCPP_INFO(get_logger(), "Invalid search weights or cur_val %f\n", cur_val);
-      }
-    }
-    new_particles.push_back(particles_[cur_index]);
+  resample_buffer_.resize(
+    kld_sampler_.IsEnabled() ? kld_sampler_.GetParticleCount(particles_) : num_particles_);
+  if (resample_strategy_ == ResampleStrategy::Residual) {
+    ResampleResidual(
+      particles_, search_weights_, resample_buffer_, residual_weights_, resample_streams_.front());
+  } else if (resample_strategy_ == ResampleStrategy::Stratified) {
+    workers_.RunChunked(
+      resample_buffer_.size(),
+      [&](const std::size_t begin, const std::size_t end, const int worker_index) {
+        ResampleEvenlySpaced(
+          particles_, search_weights_, resample_buffer_, begin, end, 0.0,
+          &resample_streams_[worker_index]);
+      });
+  } else {
+    const double offset = resample_streams_.front().Sample();
+    workers_.RunChunked(
+      resample_buffer_.size(), [&](const std::size_t begin, const std::size_t end, int) {
+        ResampleEvenlySpaced(
+          particles_, search_weights_, resample_buffer_, begin, end, offset, nullptr);
+      });
   }
-  particles_ = new_particles;
+  std::swap(particles_, resample_buffer_);
+  num_particles_ = particles_.size();
+  particles_revision_++;
+  PublishParticleCountDiagnostic(current_time);
 }
 
 void ParticleFilterLocalizer::CalculateAllParticleWeights(const rclcpp::Time & current_time)
 {
-  for (Particle & particle : particles_) {
-    CalculateParticleWeight(particle, current_time);
-  }
-  NormalizeWeights();
-}
-
-
-void ParticleFilterLocalizer::CalculateParticleWeight(
-  Particle & particle,
-  const rclcpp::Time & current_time)
-{
-  double log_probability = 0.0;
+  available_models_.clear();
+  measurement_sequences_.clear();
   for (const auto & model : sensor_models_) {
     if (model->IsMeasurementAvailable(current_time)) {
-      log_probability += -0.5 * model->ComputeLogProb(particle);
-      log_probability -= model->ComputeLogNormalizer();
+      available_models_.push_back(model.get());
+      measurement_sequences_.push_back(model->GetMeasurementSequence());
+    } else {
+      measurement_sequences_.push_back(0);
     }
   }
-  particle.weight = exp(log_probability);
+  // Nothing has moved and no measurement has arrived or expired, so the weights are still current.
+  // Recorded before normalizing, since regenerating a collapsed particle set bumps the revision.
+  if (!weight_inputs_.Update(particles_revision_, measurement_sequences_)) {
+    return;
+  }
+  log_weights_.resize(particles_.size());
+  double * weights = particles_.weight.data();
+  workers_.RunChunked(
+    particles_.size(), [&](const std::size_t begin, const std::size_t end, int) {
+      double * log_weights = log_weights_.data() + begin;
+      std::fill(log_weights, log_weights + (end - begin), 0.0);
+      for (const auto * model : available_models_) {
+        model->AccumulateLogWeights(particles_.Span(begin, end), log_weights);
+      }
+      math_.exp(log_weights, weights + begin, end - begin);
+    });
+  NormalizeWeights();
 }
 
 void ParticleFilterLocalizer::CalculateStateAndPublish()
@@ -393,9 +453,9 @@ void ParticleFilterLocalizer::PublishParticleVisualization()
 
     // create three points based off of the particle
     // The marker uses three points to create a triangle between them
-    double x = particles_[i].x;
-    double y = particles_[i].y;
-    double yaw = particles_[i].yaw;
+    double x = particles_.x[i];
+    double y = particles_.y[i];
+    double yaw = particles_.yaw[i];
 
     front_point.x = x + 0.1 * cos(yaw);
     front_point.y = y - 0.1 * sin(yaw);
@@ -415,7 +475,7 @@ void ParticleFilterLocalizer::PublishParticleVisualization()
     marker.scale.z = 1.0;
 
     // sets the color intensity based off of the max weight particle
-    marker.colors[i].r = (particles_[i].weight / max_weight_);
+    marker.colors[i].r = (particles_.weight[i] / max_weight_);
     marker.colors[i].g = 0;
     marker.colors[i].b = 0;
     marker.colors[i].a = 0.7;
@@ -425,6 +485,29 @@ void ParticleFilterLocalizer::PublishParticleVisualization()
 }
 
 
+void ParticleFilterLocalizer::PublishParticleCountDiagnostic(const rclcpp::Time & current_time)
+{
+  diagnostic_msgs::msg::DiagnosticStatus status;
+  status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+  status.name = std::string(get_name()) + ": particle count";
+  status.message = std::to_string(num_particles_) + " particles";
+  diagnostic_msgs::msg::KeyValue particle_count;
+  particle_count.key = "particle_count";
+  particle_count.value = std::to_string(num_particles_);
+  status.values.push_back(particle_count);
+  if (kld_sampler_.IsEnabled()) {
+    diagnostic_msgs::msg::KeyValue occupied_bins;
+    occupied_bins.key = "occupied_bins";
+    occupied_bins.value = std::to_string(kld_sampler_.GetOccupiedBinCount());
+    status.values.push_back(occupied_bins);
+  }
+
+  diagnostic_msgs::msg::DiagnosticArray diagnostics;
+  diagnostics.header.stamp = current_time;
+  diagnostics.status.push_back(status);
+  diagnostics_pub_->publish(diagnostics);
+}
+
 }  // namespace localization
 
 RCLCPP_COMPONENTS_REGISTER_NODE(localization::ParticleFilterLocalizer)
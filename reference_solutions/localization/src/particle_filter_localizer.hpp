@@ -24,15 +24,24 @@
 #include <tf2_ros/buffer.h>
 #include <tf2_ros/transform_listener.h>
 #include <tf2_ros/transform_broadcaster.h>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 #include <rclcpp/rclcpp.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
 #include <nav_msgs/msg/odometry.hpp>
 #include <visualization_msgs/msg/marker.hpp>
+#include "fast_math.hpp"
+#include "kld_sampler.hpp"
 #include "particle.hpp"
+#include "particle_set.hpp"
 #include "sensor_model.hpp"
 #include "motion_model.hpp"
 #include "random_helpers.hpp"
+#include "resampling.hpp"
+#include "weight_inputs.hpp"
+#include "worker_pool.hpp"
 
 namespace localization
 {
@@ -54,6 +63,7 @@ private:
   rclcpp::Subscription<geometry_msgs::msg::Twist>::SharedPtr cmd_sub_;
   rclcpp::Publisher<nav_msgs::msg::Odometry>::SharedPtr odom_pub_;
   rclcpp::Publisher<visualization_msgs::msg::Marker>::SharedPtr marker_pub_;
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr diagnostics_pub_;
 
   rclcpp::TimerBase::SharedPtr pose_timer_;
   rclcpp::TimerBase::SharedPtr resample_timer_;
@@ -62,15 +72,40 @@ private:
   tf2_ros::TransformListener tf_listener_;
   tf2_ros::TransformBroadcaster tf_broadcaster_;
 
-  std::vector<localization::Particle> particles_;
+  // Splits the motion update, weighting and resampling into fixed per-thread shares of particles
+  WorkerPool workers_;
+  // libm or the polynomial kernels, chosen by the use_fast_math parameter
+  const MathKernels & math_;
+
+  ParticleSet particles_;
+  // Back buffer ResampleParticles writes into before swapping it with particles_
+  ParticleSet resample_buffer_;
   std::vector<double> search_weights_;
+  // Scratch space reused between updates so steady state filtering doesn't allocate
+  std::vector<double> sorted_weights_;
+  std::vector<double> residual_weights_;
+  std::vector<const SensorModel *> available_models_;
+  std::vector<std::uint64_t> measurement_sequences_;
+  AlignedVector<double> sin_yaw_;
+  AlignedVector<double> cos_yaw_;
+
+  // Bumped whenever particles are moved, resampled or regenerated
+  std::uint64_t particles_revision_ = 0;
+  // What the current weights were computed from
+  WeightInputs weight_inputs_;
+  // Per-particle log weights summed over the sensor models
+  AlignedVector<double> log_weights_;
 
   UniformRandomGenerator uniform_noise_;
+  // Resampling draws for each worker's share of the new particle set
+  std::vector<UniformRandomGenerator> resample_streams_;
   std::vector<std::unique_ptr<SensorModel>> sensor_models_;
   MotionModel motion_model_;
+  KldSampler kld_sampler_;
 
   rclcpp::Time last_resample_time_;
   double resample_rate_;
+  ResampleStrategy resample_strategy_ = ResampleStrategy::Systematic;
 
   int num_particles_ = 100;
   double max_weight_ = 0;
@@ -88,13 +123,13 @@ private:
   void ResampleParticles();
   void CalculateStateAndPublish();
   void CalculateAllParticleWeights(const rclcpp::Time & current_time);
-  void CalculateParticleWeight(Particle & particle, const rclcpp::Time & current_time);
 
   void PublishEstimateOdom(
     const Particle & estimate, const Particle & covariance,
     const rclcpp::Time & current_time);
   void PublishEstimateTF(const Particle & estimate, const rclcpp::Time & current_time);
   void PublishParticleVisualization();
+  void PublishParticleCountDiagnostic(const rclcpp::Time & current_time);
 };
 
 }  // namespace localization
@@ -0,0 +1,162 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PARTICLE_SET_HPP_
+#define PARTICLE_SET_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include "particle.hpp"
+
+namespace localization
+{
+
+// Allocates on cache line boundaries so batched kernels can use aligned vector loads
+template<typename T, std::size_t Alignment = 64>
+struct AlignedAllocator
+{
+  using value_type = T;
+
+  template<typename U>
+  struct rebind
+  {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() = default;
+
+  template<typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+  T * allocate(std::size_t count)
+  {
+    return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+  }
+
+  void deallocate(T * pointer, std::size_t)
+  {
+    ::operator delete(pointer, std::align_val_t{Alignment});
+  }
+
+  template<typename U>
+  bool operator==(const AlignedAllocator<U, Alignment> &) const
+  {
+    return true;
+  }
+
+  template<typename U>
+  bool operator!=(const AlignedAllocator<U, Alignment> &) const
+  {
+    return false;
+  }
+};
+
+template<typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// Wraps an angle into [-pi, pi) without branches, so loops over a particle set can vectorize
+inline double WrapAngle(const double angle)
+{
+  return angle - 2 * M_PI * std::floor((angle + M_PI) / (2 * M_PI));
+}
+
+// Read-only view of a contiguous range of particles in a ParticleSet
+struct ParticleSpan
+{
+  const double * x;
+  const double * y;
+  const double * yaw;
+  const double * x_vel;
+  const double * yaw_vel;
+  const double * weight;
+  std::size_t size;
+};
+
+// Particles stored as one array per field, so whole-set updates walk contiguous memory
+struct ParticleSet
+{
+  // global positions
+  AlignedVector<double> x;
+  AlignedVector<double> y;
+  AlignedVector<double> yaw;
+
+  // body velocities
+  AlignedVector<double> x_vel;
+  AlignedVector<double> yaw_vel;
+
+  // normalized weights of the particles
+  AlignedVector<double> weight;
+
+  std::size_t size() const
+  {
+    return x.size();
+  }
+
+  void resize(const std::size_t count)
+  {
+    x.resize(count);
+    y.resize(count);
+    yaw.resize(count);
+    x_vel.resize(count);
+    yaw_vel.resize(count);
+    weight.resize(count, 1.0);
+  }
+
+  // Particles [begin, end)
+  ParticleSpan Span(const std::size_t begin, const std::size_t end) const
+  {
+    return ParticleSpan{
+      x.data() + begin, y.data() + begin, yaw.data() + begin, x_vel.data() + begin,
+      yaw_vel.data() + begin, weight.data() + begin, end - begin};
+  }
+
+  ParticleSpan Span() const
+  {
+    return Span(0, size());
+  }
+
+  Particle Get(const std::size_t index) const
+  {
+    Particle particle;
+    particle.x = x[index];
+    particle.y = y[index];
+    particle.yaw = yaw[index];
+    particle.x_vel = x_vel[index];
+    particle.yaw_vel = yaw_vel[index];
+    particle.weight = weight[index];
+    return particle;
+  }
+
+  void Set(const std::size_t index, const Particle & particle)
+  {
+    x[index] = particle.x;
+    y[index] = particle.y;
+    yaw[index] = particle.yaw;
+    x_vel[index] = particle.x_vel;
+    yaw_vel[index] = particle.yaw_vel;
+    weight[index] = particle.weight;
+  }
+};
+
+}  // namespace localization
+
+#endif  // PARTICLE_SET_HPP_
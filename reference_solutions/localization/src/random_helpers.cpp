@@ -19,18 +19,31 @@
 // THE SOFTWARE.
 
 #include "random_helpers.hpp"
+#include <random>
 
 namespace localization
 {
 
 // TODO(barulicm) Do we need to use a fixed random seed?
 constexpr auto RANDOM_SEED = 100;
+// Mixed into each generator type's stream seeds, so a uniform and a Gaussian generator for the
+// same stream don't draw from the same engine sequence
+constexpr unsigned int UNIFORM_STREAM_SALT = 0;
+constexpr unsigned int GAUSSIAN_STREAM_SALT = 1;
 
 UniformRandomGenerator::UniformRandomGenerator()
 : engine_(RANDOM_SEED), distribution_(0.0, 1.0)
 {
 }
 
+UniformRandomGenerator::UniformRandomGenerator(const unsigned int stream)
+: distribution_(0.0, 1.0)
+{
+  // Mixing the stream into the seed keeps streams from starting at correlated engine states
+  std::seed_seq seed{static_cast<unsigned int>(RANDOM_SEED), stream, UNIFORM_STREAM_SALT};
+  engine_.seed(seed);
+}
+
 double UniformRandomGenerator::Sample()
 {
   return distribution_(engine_);
@@ -41,6 +54,13 @@ GaussianRandomGenerator::GaussianRandomGenerator()
 {
 }
 
+GaussianRandomGenerator::GaussianRandomGenerator(const unsigned int stream)
+: distribution_(0.0, 1.0)
+{
+  std::seed_seq seed{static_cast<unsigned int>(RANDOM_SEED), stream, GAUSSIAN_STREAM_SALT};
+  engine_.seed(seed);
+}
+
 double GaussianRandomGenerator::Sample()
 {
   return distribution_(engine_);
@@ -31,6 +31,9 @@ class UniformRandomGenerator
 public:
   UniformRandomGenerator();
 
+  // Independent sequence for one of several workers sampling in parallel
+  explicit UniformRandomGenerator(const unsigned int stream);
+
   double Sample();
 
 private:
@@ -43,6 +46,10 @@ class GaussianRandomGenerator
 public:
   GaussianRandomGenerator();
 
+  // Independent sequence for one of several workers sampling in parallel, also independent of
+  // the UniformRandomGenerator with the same stream
+  explicit GaussianRandomGenerator(const unsigned int stream);
+
   double Sample();
 
 private:
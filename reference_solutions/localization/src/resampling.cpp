@@ -0,0 +1,99 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "resampling.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace localization
+{
+
+void ResampleEvenlySpaced(
+  const ParticleSet & source, const std::vector<double> & cumulative_weights,
+  ParticleSet & output, const std::size_t begin, const std::size_t end, double offset,
+  UniformRandomGenerator * stratified_offsets)
+{
+  const std::size_t last = cumulative_weights.size() - 1;
+  const double spacing = cumulative_weights.back() / output.size();
+  std::size_t source_index = 0;
+  for (std::size_t i = begin; i < end; i++) {
+    if (stratified_offsets != nullptr) {
+      offset = stratified_offsets->Sample();
+    }
+    const double position = (i + offset) * spacing;
+    if (i == begin) {
+      // Only the first position of the range needs a search, the rest walk forward from it
+      source_index =
+        std::upper_bound(cumulative_weights.begin(), cumulative_weights.end(), position) -
+        cumulative_weights.begin();
+    }
+    while (source_index < last && cumulative_weights[source_index] <= position) {
+      source_index++;
+    }
+    source_index = std::min(source_index, last);
+    output.Set(i, source.Get(source_index));
+  }
+}
+
+void ResampleResidual(
+  const ParticleSet & source, const std::vector<double> & cumulative_weights,
+  ParticleSet & output, std::vector<double> & residual_weights,
+  UniformRandomGenerator & offsets)
+{
+  const std::size_t source_count = source.size();
+  const std::size_t count = output.size();
+  const double total_weight = cumulative_weights.back();
+  const double * weights = source.weight.data();
+  residual_weights.resize(source_count);
+  std::size_t copied = 0;
+  double residual_sum = 0;
+  for (std::size_t source_index = 0; source_index < source_count; source_index++) {
+    const double expected_copies = count * weights[source_index] / total_weight;
+    const auto copies = std::min(
+      static_cast<std::size_t>(expected_copies), count - copied);
+    const Particle particle = source.Get(source_index);
+    for (std::size_t copy = 0; copy < copies; copy++) {
+      output.Set(copied++, particle);
+    }
+    residual_sum += expected_copies - copies;
+    residual_weights[source_index] = residual_sum;
+  }
+  if (copied == count) {
+    return;
+  }
+  if (residual_sum <= 0) {
+    // Rounding left slots without any residual weight, so reuse the plain weights for them
+    residual_weights = cumulative_weights;
+  }
+  // Fill the remaining slots systematically from the fractional copies each particle lost
+  const std::size_t remaining = count - copied;
+  const double spacing = residual_weights.back() / remaining;
+  const double offset = offsets.Sample();
+  std::size_t source_index = 0;
+  for (std::size_t i = 0; i < remaining; i++) {
+    const double position = (i + offset) * spacing;
+    while (source_index < source_count - 1 && residual_weights[source_index] <= position) {
+      source_index++;
+    }
+    output.Set(copied + i, source.Get(source_index));
+  }
+}
+
+}  // namespace localization
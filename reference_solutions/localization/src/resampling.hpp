@@ -0,0 +1,59 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef RESAMPLING_HPP_
+#define RESAMPLING_HPP_
+
+#include <cstddef>
+#include <vector>
+#include "particle_set.hpp"
+#include "random_helpers.hpp"
+
+namespace localization
+{
+
+// How the localizer turns weights into copies. "systematic" draws one uniform offset for evenly
+// spaced positions, "stratified" draws one per position and "residual" first copies each particle
+// floor(count * weight) times, then fills the rest systematically.
+enum class ResampleStrategy
+{
+  Systematic,
+  Stratified,
+  Residual
+};
+
+// Fills output[begin, end) from source in one forward walk over cumulative_weights, the inclusive
+// prefix sums of source's weights. Output particle i is the one whose cumulative weight range
+// contains (i + offset) / output.size() of the total weight. Stratified resampling passes a stream
+// to draw a new offset for every position.
+void ResampleEvenlySpaced(
+  const ParticleSet & source, const std::vector<double> & cumulative_weights,
+  ParticleSet & output, const std::size_t begin, const std::size_t end, double offset,
+  UniformRandomGenerator * stratified_offsets);
+
+// Fills all of output from source with residual resampling. residual_weights is scratch space.
+void ResampleResidual(
+  const ParticleSet & source, const std::vector<double> & cumulative_weights,
+  ParticleSet & output, std::vector<double> & residual_weights,
+  UniformRandomGenerator & offsets);
+
+}  // namespace localization
+
+#endif  // RESAMPLING_HPP_
@@ -21,9 +21,10 @@
 #ifndef SENSOR_MODEL_HPP_
 #define SENSOR_MODEL_HPP_
 
+#include <cstdint>
 #include <vector>
 #include <rclcpp/time.hpp>
-#include "particle.hpp"
+#include "particle_set.hpp"
 
 namespace localization
 {
@@ -32,13 +33,23 @@ class SensorModel
 {
 public:
   virtual ~SensorModel() = default;
-  virtual double ComputeLogProb(const Particle & particle) = 0;
-  virtual double ComputeLogNormalizer() = 0;
+  // Adds the log likelihood of the latest measurement, including the normalizer, to
+  // log_weights[i] for each particle i in the span
+  virtual void AccumulateLogWeights(const ParticleSpan & particles, double * log_weights) const = 0;
+  virtual double ComputeLogNormalizer() const = 0;
   virtual bool IsMeasurementAvailable(const rclcpp::Time & cur_time) = 0;
 
+  // Number of measurements received so far. Weights computed at one sequence number stay valid
+  // until it changes.
+  std::uint64_t GetMeasurementSequence() const
+  {
+    return measurement_sequence_;
+  }
+
 protected:
   std::vector<double> covariance_;
   double timeout_;
+  std::uint64_t measurement_sequence_ = 0;
 };
 }  // namespace localization
 
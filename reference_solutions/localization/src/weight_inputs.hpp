@@ -0,0 +1,60 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef WEIGHT_INPUTS_HPP_
+#define WEIGHT_INPUTS_HPP_
+
+#include <cstdint>
+#include <vector>
+
+namespace localization
+{
+
+// What a set of particle weights was computed from: the particle set's revision and each sensor
+// model's measurement sequence number, or 0 for models that weren't available. The weights only
+// need recomputing when one of these changes.
+class WeightInputs
+{
+public:
+  // Records the given inputs, returning true if they differ from the last recorded ones
+  bool Update(
+    const std::uint64_t particles_revision,
+    const std::vector<std::uint64_t> & measurement_sequences)
+  {
+    if (recorded_ && particles_revision == particles_revision_ &&
+      measurement_sequences == measurement_sequences_)
+    {
+      return false;
+    }
+    recorded_ = true;
+    particles_revision_ = particles_revision;
+    measurement_sequences_ = measurement_sequences;
+    return true;
+  }
+
+private:
+  bool recorded_ = false;
+  std::uint64_t particles_revision_ = 0;
+  std::vector<std::uint64_t> measurement_sequences_;
+};
+
+}  // namespace localization
+
+#endif  // WEIGHT_INPUTS_HPP_
@@ -0,0 +1,103 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "worker_pool.hpp"
+#include <algorithm>
+#include <functional>
+#include <mutex>
+
+namespace localization
+{
+
+WorkerPool::WorkerPool(const int thread_count)
+: thread_count_(std::max(thread_count, 1))
+{
+  for (int worker_index = 1; worker_index < thread_count_; ++worker_index) {
+    threads_.emplace_back(&WorkerPool::WorkerLoop, this, worker_index);
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  work_ready_.notify_all();
+  for (auto & thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::Run(const std::function<void(int)> & task)
+{
+  if (threads_.empty()) {
+    task(0);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    workers_remaining_ = thread_count_ - 1;
+    ++generation_;
+  }
+  work_ready_.notify_all();
+  task(0);
+  std::unique_lock<std::mutex> lock(mutex_);
+  work_done_.wait(lock, [this] {return workers_remaining_ == 0;});
+  task_ = nullptr;
+}
+
+void WorkerPool::RunChunked(
+  const std::size_t count,
+  const std::function<void(std::size_t, std::size_t, int)> & task)
+{
+  const auto thread_count = static_cast<std::size_t>(thread_count_);
+  Run(
+    [&](const int worker_index) {
+      const auto index = static_cast<std::size_t>(worker_index);
+      task(count * index / thread_count, count * (index + 1) / thread_count, worker_index);
+    });
+}
+
+void WorkerPool::WorkerLoop(const int worker_index)
+{
+  unsigned int seen_generation = 0;
+  while (true) {
+    const std::function<void(int)> * task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_ready_.wait(lock, [&] {return stopping_ || generation_ != seen_generation;});
+      if (stopping_) {
+        return;
+      }
+      seen_generation = generation_;
+      task = task_;
+    }
+    (*task)(worker_index);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --workers_remaining_;
+    }
+    work_done_.notify_one();
+  }
+}
+
+}  // namespace localization
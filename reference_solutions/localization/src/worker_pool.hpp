@@ -0,0 +1,78 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef WORKER_POOL_HPP_
+#define WORKER_POOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace localization
+{
+
+// Fixed set of threads for fork-join parallelism. Run hands every worker the same task and
+// returns once all of them have finished it.
+class WorkerPool
+{
+public:
+  explicit WorkerPool(const int thread_count);
+
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool & operator=(const WorkerPool &) = delete;
+
+  int GetThreadCount() const
+  {
+    return thread_count_;
+  }
+
+  // Calls task(worker_index) once for each index in [0, thread count). The calling thread runs
+  // index 0 itself.
+  void Run(const std::function<void(int)> & task);
+
+  // Calls task(begin, end, worker_index) with each worker's share of [0, count). Shares depend
+  // only on count and the thread count, so results are reproducible for a given thread count.
+  void RunChunked(
+    const std::size_t count,
+    const std::function<void(std::size_t, std::size_t, int)> & task);
+
+private:
+  int thread_count_;
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable work_ready_;
+  std::condition_variable work_done_;
+  const std::function<void(int)> * task_ = nullptr;
+  // Incremented for every Run call so workers can tell new work from a spurious wakeup
+  unsigned int generation_ = 0;
+  int workers_remaining_ = 0;
+  bool stopping_ = false;
+
+  void WorkerLoop(const int worker_index);
+};
+
+}  // namespace localization
+
+#endif  // WORKER_POOL_HPP_
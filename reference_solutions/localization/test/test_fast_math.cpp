@@ -0,0 +1,228 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include "fast_math.hpp"
+#include "fast_math_kernels.hpp"
+
+namespace localization
+{
+
+namespace
+{
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+constexpr std::size_t kSampleCount = 100000;
+
+// Error bounds documented in fast_math.hpp
+constexpr double kSinCosTolerance = 3e-16;
+constexpr double kAtan2Tolerance = 5e-16;
+constexpr double kExpRelativeTolerance = 4e-16;
+
+std::vector<const MathKernels *> GetPolynomialKernels()
+{
+  return {&GetScalarMathKernels(), &GetFastMathKernels()};
+}
+
+// NaN and infinite expected values must match exactly, finite ones to within tolerance
+void ExpectClose(const double expected, const double actual, const double tolerance)
+{
+  if (std::isnan(expected)) {
+    EXPECT_TRUE(std::isnan(actual)) << "expected NaN, got " << actual;
+  } else if (std::isinf(expected)) {
+    EXPECT_EQ(expected, actual);
+  } else {
+    EXPECT_NEAR(expected, actual, tolerance);
+  }
+}
+
+void ExpectSinCosMatchesLibm(const MathKernels & kernels, const std::vector<double> & angles)
+{
+  const auto count = angles.size();
+  std::vector<double> expected_sines(count), expected_cosines(count);
+  std::vector<double> sines(count), cosines(count);
+  GetLibmMathKernels().sin_cos(
+    angles.data(), expected_sines.data(), expected_cosines.data(), count);
+  kernels.sin_cos(angles.data(), sines.data(), cosines.data(), count);
+  for (std::size_t i = 0; i < count; i++) {
+    SCOPED_TRACE(angles[i]);
+    ExpectClose(expected_sines[i], sines[i], kSinCosTolerance);
+    ExpectClose(expected_cosines[i], cosines[i], kSinCosTolerance);
+  }
+}
+
+void ExpectAtan2MatchesLibm(
+  const MathKernels & kernels, const std::vector<double> & y,
+  const std::vector<double> & x)
+{
+  const auto count = y.size();
+  std::vector<double> expected(count), angles(count);
+  GetLibmMathKernels().atan2(y.data(), x.data(), expected.data(), count);
+  kernels.atan2(y.data(), x.data(), angles.data(), count);
+  for (std::size_t i = 0; i < count; i++) {
+    SCOPED_TRACE(testing::Message() << "y = " << y[i] << ", x = " << x[i]);
+    ExpectClose(expected[i], angles[i], kAtan2Tolerance);
+  }
+}
+
+void ExpectExpMatchesLibm(const MathKernels & kernels, const std::vector<double> & x)
+{
+  const auto count = x.size();
+  std::vector<double> expected(count), results(count);
+  GetLibmMathKernels().exp(x.data(), expected.data(), count);
+  kernels.exp(x.data(), results.data(), count);
+  for (std::size_t i = 0; i < count; i++) {
+    SCOPED_TRACE(x[i]);
+    ExpectClose(expected[i], results[i], kExpRelativeTolerance * std::fabs(expected[i]));
+  }
+}
+
+}  // namespace
+
+TEST(FastMath, SinCosMatchesLibm)
+{
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> angle(-1e5, 1e5);
+  std::uniform_real_distribution<double> small_angle(-10.0, 10.0);
+  std::vector<double> angles;
+  for (std::size_t i = 0; i < kSampleCount; i++) {
+    angles.push_back(i % 2 == 0 ? angle(rng) : small_angle(rng));
+  }
+  for (const auto kernels : GetPolynomialKernels()) {
+    SCOPED_TRACE(kernels->name);
+    ExpectSinCosMatchesLibm(*kernels, angles);
+  }
+}
+
+TEST(FastMath, Atan2MatchesLibm)
+{
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> exponent(-300.0, 300.0);
+  std::uniform_real_distribution<double> factor(0.5, 2.0);
+  std::bernoulli_distribution negative(0.5);
+  auto random_value = [&]() {
+      const auto magnitude = std::pow(10.0, exponent(rng));
+      return negative(rng) ? -magnitude : magnitude;
+    };
+  std::vector<double> y, x;
+  for (std::size_t i = 0; i < kSampleCount; i++) {
+    y.push_back(random_value());
+    // Every other pair has similar magnitudes, which exercises the reduction around pi / 4
+    x.push_back(
+      i % 2 == 0 ? random_value() : y.back() * factor(rng) * (negative(rng) ? -1.0 : 1.0));
+  }
+  for (const auto kernels : GetPolynomialKernels()) {
+    SCOPED_TRACE(kernels->name);
+    ExpectAtan2MatchesLibm(*kernels, y, x);
+  }
+}
+
+TEST(FastMath, ExpMatchesLibm)
+{
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> value(fast_math::kExpMin, fast_math::kExpMax);
+  std::uniform_real_distribution<double> small_value(-1.0, 1.0);
+  std::vector<double> x;
+  for (std::size_t i = 0; i < kSampleCount; i++) {
+    x.push_back(i % 2 == 0 ? value(rng) : small_value(rng));
+  }
+  for (const auto kernels : GetPolynomialKernels()) {
+    SCOPED_TRACE(kernels->name);
+    ExpectExpMatchesLibm(*kernels, x);
+  }
+}
+
+TEST(FastMath, EdgeInputsMatchLibm)
+{
+  const std::vector<double> values{kNaN, kInfinity, -kInfinity, 0.0, -0.0, 1.0, -1.0};
+  std::vector<double> y, x;
+  for (const auto y_value : values) {
+    for (const auto x_value : values) {
+      y.push_back(y_value);
+      x.push_back(x_value);
+    }
+  }
+  for (const auto kernels : GetPolynomialKernels()) {
+    SCOPED_TRACE(kernels->name);
+    ExpectSinCosMatchesLibm(*kernels, values);
+    ExpectAtan2MatchesLibm(*kernels, y, x);
+    ExpectExpMatchesLibm(*kernels, values);
+  }
+}
+
+TEST(FastMath, ExpSaturatesOutsideRange)
+{
+  const std::vector<double> x{-1000.0, -708.5, 709.5, 1000.0};
+  std::vector<double> results(x.size());
+  for (const auto kernels : GetPolynomialKernels()) {
+    SCOPED_TRACE(kernels->name);
+    kernels->exp(x.data(), results.data(), x.size());
+    EXPECT_EQ(0.0, results[0]);
+    EXPECT_EQ(0.0, results[1]);
+    EXPECT_NEAR(std::exp(709.0), results[2], kExpRelativeTolerance * std::exp(709.0));
+    EXPECT_NEAR(std::exp(709.0), results[3], kExpRelativeTolerance * std::exp(709.0));
+  }
+}
+
+// Counts that aren't a multiple of the vector width go through the zero padded tail, which must
+// only write the requested elements
+TEST(FastMath, PartialVectorsMatchLibm)
+{
+  constexpr double kSentinel = 12345.0;
+  for (const auto kernels : GetPolynomialKernels()) {
+    SCOPED_TRACE(kernels->name);
+    for (std::size_t count = 0; count <= 9; count++) {
+      SCOPED_TRACE(count);
+      std::vector<double> inputs(count), second_inputs(count);
+      for (std::size_t i = 0; i < count; i++) {
+        inputs[i] = 0.7 * i - 2.0;
+        second_inputs[i] = 1.0 - 0.3 * i;
+      }
+      std::vector<double> expected(count + 1, kSentinel), expected_second(count + 1, kSentinel);
+      std::vector<double> results(count + 1, kSentinel), second_results(count + 1, kSentinel);
+
+      GetLibmMathKernels().sin_cos(inputs.data(), expected.data(), expected_second.data(), count);
+      kernels->sin_cos(inputs.data(), results.data(), second_results.data(), count);
+      for (std::size_t i = 0; i <= count; i++) {
+        ExpectClose(expected[i], results[i], kSinCosTolerance);
+        ExpectClose(expected_second[i], second_results[i], kSinCosTolerance);
+      }
+
+      GetLibmMathKernels().atan2(inputs.data(), second_inputs.data(), expected.data(), count);
+      kernels->atan2(inputs.data(), second_inputs.data(), results.data(), count);
+      for (std::size_t i = 0; i <= count; i++) {
+        ExpectClose(expected[i], results[i], kAtan2Tolerance);
+      }
+
+      GetLibmMathKernels().exp(inputs.data(), expected.data(), count);
+      kernels->exp(inputs.data(), results.data(), count);
+      for (std::size_t i = 0; i <= count; i++) {
+        ExpectClose(expected[i], results[i], kExpRelativeTolerance * std::fabs(expected[i]));
+      }
+    }
+  }
+}
+
+}  // namespace localization
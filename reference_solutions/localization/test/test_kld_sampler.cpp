@@ -0,0 +1,129 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <rclcpp/rclcpp.hpp>
+#include "kld_sampler.hpp"
+#include "particle_set.hpp"
+
+namespace localization
+{
+
+namespace
+{
+
+constexpr double kBinSize = 0.05;
+
+class KldSamplerTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestSuite()
+  {
+    rclcpp::shutdown();
+  }
+
+  // Sampler with the default error bound and quantile, and wide particle count limits
+  static KldSampler MakeSampler(const std::vector<rclcpp::Parameter> & overrides = {})
+  {
+    std::vector<rclcpp::Parameter> parameters{
+      {"kld_sampling.enabled", true},
+      {"kld_sampling.min_particles", 1},
+      {"kld_sampling.max_particles", 100000},
+      {"kld_sampling.xy_bin_size", kBinSize}};
+    parameters.insert(parameters.end(), overrides.begin(), overrides.end());
+    rclcpp::Node node("kld_sampler_test", rclcpp::NodeOptions().parameter_overrides(parameters));
+    return KldSampler(node);
+  }
+};
+
+// `copies` particles in the middle of each of `bin_count` neighboring position bins
+ParticleSet MakeParticlesInBins(const int bin_count, const int copies)
+{
+  ParticleSet particles;
+  particles.resize(bin_count * copies);
+  for (int bin = 0; bin < bin_count; bin++) {
+    for (int copy = 0; copy < copies; copy++) {
+      Particle particle;
+      particle.x = (bin % 20 + 0.5) * kBinSize;
+      particle.y = (bin / 20 + 0.5) * kBinSize;
+      particle.weight = 1.0 / (bin_count * copies);
+      particles.Set(bin * copies + copy, particle);
+    }
+  }
+  return particles;
+}
+
+}  // namespace
+
+TEST_F(KldSamplerTest, CountMatchesBoundForOccupiedBins)
+{
+  auto sampler = MakeSampler();
+  // ceil((k - 1) / (2 * 0.05) * (1 - a + sqrt(a) * 2.33)^3) with a = 2 / (9 * (k - 1))
+  const std::vector<std::pair<int, std::size_t>> expected_counts{
+    {2, 67}, {10, 218}, {50, 750}, {400, 4678}};
+  for (const auto & [bin_count, expected_count] : expected_counts) {
+    SCOPED_TRACE(bin_count);
+    EXPECT_EQ(expected_count, sampler.GetParticleCount(MakeParticlesInBins(bin_count, 3)));
+    EXPECT_EQ(static_cast<std::size_t>(bin_count), sampler.GetOccupiedBinCount());
+  }
+}
+
+TEST_F(KldSamplerTest, ZeroWeightParticlesOccupyNoBins)
+{
+  auto sampler = MakeSampler();
+  auto particles = MakeParticlesInBins(10, 2);
+  for (std::size_t i = 0; i < 6; i++) {
+    particles.weight[i] = 0.0;
+  }
+  // The first three bins only hold zero weight particles
+  sampler.GetParticleCount(particles);
+  EXPECT_EQ(7u, sampler.GetOccupiedBinCount());
+}
+
+TEST_F(KldSamplerTest, CountIsClampedToLimits)
+{
+  auto sampler = MakeSampler(
+    {{"kld_sampling.min_particles", 100}, {"kld_sampling.max_particles", 500}});
+  EXPECT_EQ(100u, sampler.GetParticleCount(MakeParticlesInBins(1, 10)));
+  EXPECT_EQ(100u, sampler.GetParticleCount(MakeParticlesInBins(2, 10)));
+  EXPECT_EQ(218u, sampler.GetParticleCount(MakeParticlesInBins(10, 10)));
+  EXPECT_EQ(500u, sampler.GetParticleCount(MakeParticlesInBins(50, 10)));
+  EXPECT_EQ(500u, sampler.GetMaxParticles());
+}
+
+TEST_F(KldSamplerTest, RejectsNonPositiveParameters)
+{
+  EXPECT_THROW(MakeSampler({{"kld_sampling.min_particles", 0}}), std::runtime_error);
+  EXPECT_THROW(MakeSampler({{"kld_sampling.max_particles", -5}}), std::runtime_error);
+  EXPECT_THROW(MakeSampler({{"kld_sampling.max_error", 0.0}}), std::runtime_error);
+  EXPECT_THROW(MakeSampler({{"kld_sampling.xy_bin_size", -0.1}}), std::runtime_error);
+  EXPECT_THROW(MakeSampler({{"kld_sampling.yaw_bin_size", 0.0}}), std::runtime_error);
+}
+
+}  // namespace localization
@@ -0,0 +1,136 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include "particle_set.hpp"
+
+namespace localization
+{
+
+namespace
+{
+
+Particle MakeParticle(const double seed)
+{
+  Particle particle;
+  particle.x = seed;
+  particle.y = seed + 1;
+  particle.yaw = seed + 2;
+  particle.x_vel = seed + 3;
+  particle.yaw_vel = seed + 4;
+  particle.weight = seed + 5;
+  return particle;
+}
+
+void ExpectSameParticle(const Particle & expected, const Particle & actual)
+{
+  EXPECT_EQ(expected.x, actual.x);
+  EXPECT_EQ(expected.y, actual.y);
+  EXPECT_EQ(expected.yaw, actual.yaw);
+  EXPECT_EQ(expected.x_vel, actual.x_vel);
+  EXPECT_EQ(expected.yaw_vel, actual.yaw_vel);
+  EXPECT_EQ(expected.weight, actual.weight);
+}
+
+bool IsCacheLineAligned(const double * pointer)
+{
+  return reinterpret_cast<std::uintptr_t>(pointer) % 64 == 0;
+}
+
+}  // namespace
+
+TEST(ParticleSet, ResizeKeepsFieldsInStep)
+{
+  ParticleSet particles;
+  particles.resize(5);
+  EXPECT_EQ(5u, particles.size());
+  EXPECT_EQ(5u, particles.y.size());
+  EXPECT_EQ(5u, particles.yaw.size());
+  EXPECT_EQ(5u, particles.x_vel.size());
+  EXPECT_EQ(5u, particles.yaw_vel.size());
+  ASSERT_EQ(5u, particles.weight.size());
+  for (const auto weight : particles.weight) {
+    EXPECT_EQ(1.0, weight);
+  }
+}
+
+TEST(ParticleSet, SetAndGetRoundTrip)
+{
+  ParticleSet particles;
+  particles.resize(4);
+  for (std::size_t i = 0; i < particles.size(); i++) {
+    particles.Set(i, MakeParticle(10.0 * i));
+  }
+  for (std::size_t i = 0; i < particles.size(); i++) {
+    ExpectSameParticle(MakeParticle(10.0 * i), particles.Get(i));
+  }
+  EXPECT_EQ(21.0, particles.y[2]);
+  EXPECT_EQ(35.0, particles.weight[3]);
+}
+
+TEST(ParticleSet, SpansViewEveryField)
+{
+  ParticleSet particles;
+  particles.resize(6);
+  for (std::size_t i = 0; i < particles.size(); i++) {
+    particles.Set(i, MakeParticle(10.0 * i));
+  }
+  const auto span = particles.Span(2, 5);
+  ASSERT_EQ(3u, span.size);
+  for (std::size_t i = 0; i < span.size; i++) {
+    const auto expected = MakeParticle(10.0 * (i + 2));
+    EXPECT_EQ(expected.x, span.x[i]);
+    EXPECT_EQ(expected.y, span.y[i]);
+    EXPECT_EQ(expected.yaw, span.yaw[i]);
+    EXPECT_EQ(expected.x_vel, span.x_vel[i]);
+    EXPECT_EQ(expected.yaw_vel, span.yaw_vel[i]);
+    EXPECT_EQ(expected.weight, span.weight[i]);
+  }
+  EXPECT_EQ(particles.size(), particles.Span().size);
+}
+
+TEST(ParticleSet, FieldsAreCacheLineAligned)
+{
+  ParticleSet particles;
+  for (const std::size_t count : {1u, 3u, 100u}) {
+    particles.resize(count);
+    EXPECT_TRUE(IsCacheLineAligned(particles.x.data()));
+    EXPECT_TRUE(IsCacheLineAligned(particles.y.data()));
+    EXPECT_TRUE(IsCacheLineAligned(particles.yaw.data()));
+    EXPECT_TRUE(IsCacheLineAligned(particles.x_vel.data()));
+    EXPECT_TRUE(IsCacheLineAligned(particles.yaw_vel.data()));
+    EXPECT_TRUE(IsCacheLineAligned(particles.weight.data()));
+  }
+}
+
+TEST(ParticleSet, WrapAngleStaysInRange)
+{
+  for (double angle = -20.0; angle <= 20.0; angle += 0.01) {
+    SCOPED_TRACE(angle);
+    const auto wrapped = WrapAngle(angle);
+    EXPECT_GE(wrapped, -M_PI);
+    EXPECT_LT(wrapped, M_PI);
+    EXPECT_NEAR(0.0, std::remainder(wrapped - angle, 2 * M_PI), 1e-12);
+  }
+}
+
+}  // namespace localization
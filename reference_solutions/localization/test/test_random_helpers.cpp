@@ -0,0 +1,102 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "random_helpers.hpp"
+
+namespace localization
+{
+
+namespace
+{
+
+constexpr unsigned int kStreamCount = 2000;
+
+double GetCorrelation(const std::vector<double> & a, const std::vector<double> & b)
+{
+  const auto count = static_cast<double>(a.size());
+  double mean_a = 0.0;
+  double mean_b = 0.0;
+  for (std::size_t i = 0; i < a.size(); i++) {
+    mean_a += a[i] / count;
+    mean_b += b[i] / count;
+  }
+  double covariance = 0.0;
+  double variance_a = 0.0;
+  double variance_b = 0.0;
+  for (std::size_t i = 0; i < a.size(); i++) {
+    covariance += (a[i] - mean_a) * (b[i] - mean_b);
+    variance_a += (a[i] - mean_a) * (a[i] - mean_a);
+    variance_b += (b[i] - mean_b) * (b[i] - mean_b);
+  }
+  return covariance / std::sqrt(variance_a * variance_b);
+}
+
+}  // namespace
+
+TEST(RandomHelpers, StreamsAreReproducible)
+{
+  UniformRandomGenerator first(3);
+  UniformRandomGenerator second(3);
+  GaussianRandomGenerator first_gaussian(3);
+  GaussianRandomGenerator second_gaussian(3);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(first.Sample(), second.Sample());
+    EXPECT_EQ(first_gaussian.Sample(), second_gaussian.Sample());
+  }
+}
+
+TEST(RandomHelpers, StreamsDiffer)
+{
+  UniformRandomGenerator first(0);
+  UniformRandomGenerator second(1);
+  GaussianRandomGenerator first_gaussian(0);
+  GaussianRandomGenerator second_gaussian(1);
+  int uniform_matches = 0;
+  int gaussian_matches = 0;
+  for (int i = 0; i < 100; i++) {
+    uniform_matches += first.Sample() == second.Sample();
+    gaussian_matches += first_gaussian.Sample() == second_gaussian.Sample();
+  }
+  EXPECT_EQ(0, uniform_matches);
+  EXPECT_EQ(0, gaussian_matches);
+}
+
+// Normal distributions turn pairs of uniform engine draws into samples, so a Gaussian stream
+// sharing its engine sequence with the uniform stream of the same index would make each first
+// Gaussian sample strongly correlated with one of the first two uniform samples
+TEST(RandomHelpers, UniformAndGaussianStreamsAreIndependent)
+{
+  std::vector<double> first_uniform, second_uniform, gaussian;
+  for (unsigned int stream = 0; stream < kStreamCount; stream++) {
+    UniformRandomGenerator uniform_generator(stream);
+    GaussianRandomGenerator gaussian_generator(stream);
+    first_uniform.push_back(uniform_generator.Sample());
+    second_uniform.push_back(uniform_generator.Sample());
+    gaussian.push_back(gaussian_generator.Sample());
+  }
+  // About 4.5 standard errors for independent samples
+  EXPECT_LT(std::fabs(GetCorrelation(first_uniform, gaussian)), 0.1);
+  EXPECT_LT(std::fabs(GetCorrelation(second_uniform, gaussian)), 0.1);
+}
+
+}  // namespace localization
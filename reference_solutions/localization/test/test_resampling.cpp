@@ -0,0 +1,184 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "particle_set.hpp"
+#include "random_helpers.hpp"
+#include "resampling.hpp"
+
+namespace localization
+{
+
+namespace
+{
+
+// Source particle i has x == i, so copies can be traced back to their source
+ParticleSet MakeParticles(const std::vector<double> & weights)
+{
+  ParticleSet particles;
+  particles.resize(weights.size());
+  for (std::size_t i = 0; i < weights.size(); i++) {
+    Particle particle;
+    particle.x = i;
+    particle.y = -1.0 * i;
+    particle.yaw = 0.1 * i;
+    particle.weight = weights[i];
+    particles.Set(i, particle);
+  }
+  return particles;
+}
+
+std::vector<double> GetCumulativeWeights(const ParticleSet & particles)
+{
+  std::vector<double> cumulative_weights;
+  double running_sum = 0;
+  for (const auto weight : particles.weight) {
+    running_sum += weight;
+    cumulative_weights.push_back(running_sum);
+  }
+  return cumulative_weights;
+}
+
+std::vector<int> CountCopies(const ParticleSet & source, const ParticleSet & output)
+{
+  std::vector<int> copies(source.size(), 0);
+  for (std::size_t i = 0; i < output.size(); i++) {
+    const auto source_index = static_cast<std::size_t>(output.x[i]);
+    EXPECT_LT(source_index, source.size());
+    EXPECT_EQ(source.y[source_index], output.y[i]);
+    EXPECT_EQ(source.yaw[source_index], output.yaw[i]);
+    copies[source_index]++;
+  }
+  return copies;
+}
+
+// Every particle is copied count * weight times, give or take less than `slack`
+void ExpectCopiesMatchWeights(
+  const ParticleSet & source, const ParticleSet & output, const double slack)
+{
+  const auto copies = CountCopies(source, output);
+  const auto total_weight = GetCumulativeWeights(source).back();
+  for (std::size_t i = 0; i < source.size(); i++) {
+    SCOPED_TRACE(i);
+    const auto expected = output.size() * source.weight[i] / total_weight;
+    EXPECT_LT(std::fabs(copies[i] - expected), slack);
+    if (source.weight[i] == 0) {
+      EXPECT_EQ(0, copies[i]);
+    }
+  }
+}
+
+const std::vector<double> kWeights{0.1, 0.2, 0.0, 0.3, 0.4};
+
+}  // namespace
+
+TEST(Resampling, SystematicCopiesMatchWeights)
+{
+  const auto source = MakeParticles(kWeights);
+  const auto cumulative_weights = GetCumulativeWeights(source);
+  for (const double offset : {0.0, 0.25, 0.5, 0.999}) {
+    SCOPED_TRACE(offset);
+    ParticleSet output;
+    output.resize(10);
+    ResampleEvenlySpaced(source, cumulative_weights, output, 0, 10, offset, nullptr);
+    // Ten evenly spaced draws over weights in tenths land exactly count * weight times each
+    EXPECT_EQ((std::vector<int>{1, 2, 0, 3, 4}), CountCopies(source, output));
+
+    output.resize(7);
+    ResampleEvenlySpaced(source, cumulative_weights, output, 0, 7, offset, nullptr);
+    ExpectCopiesMatchWeights(source, output, 1.0);
+  }
+}
+
+TEST(Resampling, SystematicRangesMatchOnePass)
+{
+  const auto source = MakeParticles(kWeights);
+  const auto cumulative_weights = GetCumulativeWeights(source);
+  ParticleSet whole;
+  whole.resize(13);
+  ResampleEvenlySpaced(source, cumulative_weights, whole, 0, 13, 0.3, nullptr);
+  ParticleSet pieces;
+  pieces.resize(13);
+  ResampleEvenlySpaced(source, cumulative_weights, pieces, 5, 13, 0.3, nullptr);
+  ResampleEvenlySpaced(source, cumulative_weights, pieces, 0, 5, 0.3, nullptr);
+  EXPECT_EQ(whole.x, pieces.x);
+}
+
+TEST(Resampling, StratifiedCopiesMatchWeights)
+{
+  const auto source = MakeParticles(kWeights);
+  const auto cumulative_weights = GetCumulativeWeights(source);
+  UniformRandomGenerator offsets(0);
+  for (int trial = 0; trial < 20; trial++) {
+    ParticleSet output;
+    output.resize(50);
+    ResampleEvenlySpaced(source, cumulative_weights, output, 0, 50, 0.0, &offsets);
+    // Each draw stays in its own stratum, so a particle's count is off by less than two
+    ExpectCopiesMatchWeights(source, output, 2.0);
+  }
+}
+
+TEST(Resampling, ResidualCopiesMatchWeights)
+{
+  const auto source = MakeParticles({0.15, 0.25, 0.0, 0.6});
+  const auto cumulative_weights = GetCumulativeWeights(source);
+  std::vector<double> residual_weights;
+  UniformRandomGenerator offsets(0);
+  for (int trial = 0; trial < 20; trial++) {
+    ParticleSet output;
+    output.resize(10);
+    ResampleResidual(source, cumulative_weights, output, residual_weights, offsets);
+    // Six whole copies of the last particle and three of the first two, which share the one
+    // remaining slot through their half copies
+    const auto copies = CountCopies(source, output);
+    EXPECT_EQ(10, copies[0] + copies[1] + copies[3]);
+    EXPECT_EQ(4, copies[0] + copies[1]);
+    EXPECT_GE(copies[0], 1);
+    EXPECT_GE(copies[1], 2);
+    EXPECT_EQ(0, copies[2]);
+    EXPECT_EQ(6, copies[3]);
+  }
+
+  ParticleSet output;
+  output.resize(23);
+  ResampleResidual(
+    MakeParticles(kWeights), GetCumulativeWeights(MakeParticles(kWeights)), output,
+    residual_weights, offsets);
+  ExpectCopiesMatchWeights(MakeParticles(kWeights), output, 1.0);
+}
+
+TEST(Resampling, UnnormalizedWeightsAreScaled)
+{
+  const auto source = MakeParticles({1.0, 2.0, 0.0, 3.0, 4.0});
+  const auto cumulative_weights = GetCumulativeWeights(source);
+  ParticleSet output;
+  output.resize(10);
+  ResampleEvenlySpaced(source, cumulative_weights, output, 0, 10, 0.5, nullptr);
+  EXPECT_EQ((std::vector<int>{1, 2, 0, 3, 4}), CountCopies(source, output));
+
+  std::vector<double> residual_weights;
+  UniformRandomGenerator offsets(0);
+  ResampleResidual(source, cumulative_weights, output, residual_weights, offsets);
+  EXPECT_EQ((std::vector<int>{1, 2, 0, 3, 4}), CountCopies(source, output));
+}
+
+}  // namespace localization
@@ -0,0 +1,58 @@
+// Copyright 2021 RoboJackets
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include "weight_inputs.hpp"
+
+namespace localization
+{
+
+TEST(WeightInputs, FirstInputsNeedWeighting)
+{
+  WeightInputs inputs;
+  EXPECT_TRUE(inputs.Update(0, {}));
+}
+
+TEST(WeightInputs, RepeatedMeasurementSequenceSkipsReweighting)
+{
+  WeightInputs inputs;
+  EXPECT_TRUE(inputs.Update(1, {5, 7}));
+  EXPECT_FALSE(inputs.Update(1, {5, 7}));
+  EXPECT_FALSE(inputs.Update(1, {5, 7}));
+}
+
+TEST(WeightInputs, ChangesNeedReweighting)
+{
+  WeightInputs inputs;
+  EXPECT_TRUE(inputs.Update(1, {5, 7}));
+  // A new measurement from the second model
+  EXPECT_TRUE(inputs.Update(1, {5, 8}));
+  EXPECT_FALSE(inputs.Update(1, {5, 8}));
+  // Particles moved or resampled
+  EXPECT_TRUE(inputs.Update(2, {5, 8}));
+  EXPECT_FALSE(inputs.Update(2, {5, 8}));
+  // The first model's measurement expired
+  EXPECT_TRUE(inputs.Update(2, {0, 8}));
+  EXPECT_FALSE(inputs.Update(2, {0, 8}));
+  // A model was added
+  EXPECT_TRUE(inputs.Update(2, {0, 8, 1}));
+}
+
+}  // namespace localization